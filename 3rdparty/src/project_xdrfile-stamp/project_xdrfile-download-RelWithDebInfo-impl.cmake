@@ -0,0 +1,30 @@
+set(command "/usr/bin/cmake;-P;/root/repo/3rdparty/src/project_xdrfile-stamp/download-project_xdrfile.cmake")
+
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(result)
+  set(msg "Command failed (${result}):\n")
+  foreach(arg IN LISTS command)
+    set(msg "${msg} '${arg}'")
+  endforeach()
+  message(FATAL_ERROR "${msg}")
+endif()
+set(command "/usr/bin/cmake;-P;/root/repo/3rdparty/src/project_xdrfile-stamp/verify-project_xdrfile.cmake")
+
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(result)
+  set(msg "Command failed (${result}):\n")
+  foreach(arg IN LISTS command)
+    set(msg "${msg} '${arg}'")
+  endforeach()
+  message(FATAL_ERROR "${msg}")
+endif()
+set(command "/usr/bin/cmake;-P;/root/repo/3rdparty/src/project_xdrfile-stamp/extract-project_xdrfile.cmake")
+
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(result)
+  set(msg "Command failed (${result}):\n")
+  foreach(arg IN LISTS command)
+    set(msg "${msg} '${arg}'")
+  endforeach()
+  message(FATAL_ERROR "${msg}")
+endif()
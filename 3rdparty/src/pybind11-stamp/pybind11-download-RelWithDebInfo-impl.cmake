@@ -0,0 +1,30 @@
+set(command "/usr/bin/cmake;-P;/root/repo/3rdparty/src/pybind11-stamp/download-pybind11.cmake")
+
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(result)
+  set(msg "Command failed (${result}):\n")
+  foreach(arg IN LISTS command)
+    set(msg "${msg} '${arg}'")
+  endforeach()
+  message(FATAL_ERROR "${msg}")
+endif()
+set(command "/usr/bin/cmake;-P;/root/repo/3rdparty/src/pybind11-stamp/verify-pybind11.cmake")
+
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(result)
+  set(msg "Command failed (${result}):\n")
+  foreach(arg IN LISTS command)
+    set(msg "${msg} '${arg}'")
+  endforeach()
+  message(FATAL_ERROR "${msg}")
+endif()
+set(command "/usr/bin/cmake;-P;/root/repo/3rdparty/src/pybind11-stamp/extract-pybind11.cmake")
+
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(result)
+  set(msg "Command failed (${result}):\n")
+  foreach(arg IN LISTS command)
+    set(msg "${msg} '${arg}'")
+  endforeach()
+  message(FATAL_ERROR "${msg}")
+endif()
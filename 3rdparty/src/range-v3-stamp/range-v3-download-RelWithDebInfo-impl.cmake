@@ -0,0 +1,30 @@
+set(command "/usr/bin/cmake;-P;/root/repo/3rdparty/src/range-v3-stamp/download-range-v3.cmake")
+
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(result)
+  set(msg "Command failed (${result}):\n")
+  foreach(arg IN LISTS command)
+    set(msg "${msg} '${arg}'")
+  endforeach()
+  message(FATAL_ERROR "${msg}")
+endif()
+set(command "/usr/bin/cmake;-P;/root/repo/3rdparty/src/range-v3-stamp/verify-range-v3.cmake")
+
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(result)
+  set(msg "Command failed (${result}):\n")
+  foreach(arg IN LISTS command)
+    set(msg "${msg} '${arg}'")
+  endforeach()
+  message(FATAL_ERROR "${msg}")
+endif()
+set(command "/usr/bin/cmake;-P;/root/repo/3rdparty/src/range-v3-stamp/extract-range-v3.cmake")
+
+execute_process(COMMAND ${command} RESULT_VARIABLE result)
+if(result)
+  set(msg "Command failed (${result}):\n")
+  foreach(arg IN LISTS command)
+    set(msg "${msg} '${arg}'")
+  endforeach()
+  message(FATAL_ERROR "${msg}")
+endif()
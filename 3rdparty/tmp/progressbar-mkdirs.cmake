@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/3rdparty/src/progressbar"
+  "/root/repo/3rdparty/src/progressbar-build"
+  "/root/repo/3rdparty"
+  "/root/repo/3rdparty/tmp"
+  "/root/repo/3rdparty/src/progressbar-stamp"
+  "/root/repo/3rdparty/src"
+  "/root/repo/3rdparty/src/progressbar-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/3rdparty/src/progressbar-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/3rdparty/src/progressbar-stamp${cfgdir}") # cfgdir has leading slash
+endif()
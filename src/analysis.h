@@ -22,6 +22,12 @@ namespace Faunus {
             protected:
             int steps=0; //!< Sample interval (do not modify)
             int cnt=0;   //!< number of samples
+            std::map<std::string, BlockAverage<double>> blockavg; //!< Sampled scalars w. error estimates, reported in json
+
+            double mean(const std::string &key) const {
+                auto it = blockavg.find(key);
+                return (it==blockavg.end() || it->second.empty()) ? 0 : it->second.avg();
+            } //!< Mean of the sampled scalar `key` (zero if not sampled)
 
             public:
             std::string name; //!< descriptive name
@@ -35,6 +41,11 @@ namespace Faunus {
                     _j["relative time"] = _round( timer.result() );
                     _j["nstep"] = steps;
                     _j["samples"] = cnt;
+                    for (auto &i : blockavg)
+                        if (!i.second.empty()) {
+                            _j["block averages"][i.first] = i.second;
+                            _roundjson(_j["block averages"][i.first], 5);
+                        }
                 }
                 if (!cite.empty())
                     _j["reference"] = cite;
@@ -45,6 +56,10 @@ namespace Faunus {
                 _from_json(j);
             } //!< configure from json object
 
+            double relativeTime() const { return timer.result(); } //!< Fraction of run time spent in analysis
+
+            inline virtual size_t memory() const { return 0; } //!< Estimated memory use incl. projected growth (bytes)
+
             inline virtual void sample() {
                 stepcnt++;
                 if ( stepcnt == steps ) {
@@ -79,7 +94,6 @@ namespace Faunus {
                 int ninsert;
                 int molid;        // molecule id
                 bool absolute_z=false;
-                Average<double> expu;
                 Change change;
 
                 void _sample() override {
@@ -103,7 +117,7 @@ namespace Faunus {
                                     g.cm = Geometry::massCenter(g.begin(), g.end(),
                                             spc.geo.boundaryFunc, -g.begin()->pos);
 
-                                expu += exp( -pot->energy(change) ); // widom average
+                                blockavg["exp(-du)"] += exp( -pot->energy(change) ); // widom average
                             }
                         }
                         g.resize(0); // deactive molecule
@@ -111,10 +125,11 @@ namespace Faunus {
                 }
 
                 void _to_json(json &j) const override {
-                    double excess = -std::log(expu.avg());
+                    double excess = -std::log(mean("exp(-du)"));
+                    auto it = blockavg.find("exp(-du)");
                     j = {
                         { "dir", rins.dir }, { "molecule", molname },
-                        { "insertions", expu.cnt }, { "absz", absolute_z },
+                        { "insertions", (it==blockavg.end()) ? 0 : it->second.size() }, { "absz", absolute_z },
                         { u8::mu+"/kT",
                             {
                                 { "excess", excess }
@@ -485,9 +500,8 @@ namespace Faunus {
                 typedef typename Tspace::Tpvec Tpvec;
 
                 std::map<int, Table2D<double,double>> dhist;  //Density histograms
-                std::map<int, Average<double>> rho_mol, rho_atom;
                 std::map<int,int> Nmol, Natom;
-                Average<double> Lavg, Vavg, invVavg;
+                std::set<int> atomids, molids; //!< Sampled atom and molecule types
                 //inline void normalize();
                 inline void _sample() override {
                     // count atom and groups of individual id's
@@ -495,9 +509,9 @@ namespace Faunus {
                     Natom.clear();
 
                     double V = spc.geo.getVolume();
-                    Vavg += V;
-                    Lavg += std::cbrt(V);
-                    invVavg += 1/V;
+                    blockavg["V"] += V;
+                    blockavg["1/V"] += 1/V;
+                    blockavg[u8::cuberoot+"V"] += std::cbrt(V);
 
                     for (auto &g : spc.groups)
                         if (g.atomic) {
@@ -509,27 +523,35 @@ namespace Faunus {
                             if (!g.empty())
                                 Nmol[g.id]++;
 
-                    for (auto &i : Nmol)
-                        rho_mol[i.first] += i.second/V;
+                    for (auto &i : Nmol) {
+                        blockavg["c/M molecule " + molecules<Tpvec>.at(i.first).name] += i.second/V / 1.0_molar;
+                        molids.insert(i.first);
+                    }
 
-                    for (auto &i : Natom)
-                        rho_atom[i.first] += i.second/V;
+                    for (auto &i : Natom) {
+                        blockavg["c/M atom " + atoms<Tparticle>.at(i.first).name] += i.second/V / 1.0_molar;
+                        atomids.insert(i.first);
+                    }
                 }
 
                 inline void _to_json(json &j) const override {
                     using namespace u8;
-                    j[ bracket( "V" ) ] = Vavg.avg();
-                    j[ bracket( "1/V" ) ] = invVavg.avg();
-                    j[ bracket( cuberoot + "V" ) ] = Lavg.avg();
-                    j[ cuberoot + bracket("V") ] = std::cbrt(Vavg.avg());
+                    j[ bracket( "V" ) ] = mean("V");
+                    j[ bracket( "1/V" ) ] = mean("1/V");
+                    j[ bracket( cuberoot + "V" ) ] = mean(cuberoot+"V");
+                    j[ cuberoot + bracket("V") ] = std::cbrt(mean("V"));
 
                     auto &_j = j["atomic"];
-                    for (auto &i : rho_atom)
-                        _j[ atoms<Tparticle>.at(i.first).name ] = json({{ "c/M", _round(i.second.avg() / 1.0_molar) }});
+                    for (int id : atomids) {
+                        auto &name = atoms<Tparticle>.at(id).name;
+                        _j[name] = json({{ "c/M", _round(mean("c/M atom " + name)) }});
+                    }
 
                     auto &_jj = j["molecular"];
-                    for (auto &i : rho_mol)
-                        _jj[ molecules<Tpvec>.at(i.first).name ] = json({{ "c/M", _round(i.second.avg() / 1.0_molar) }});
+                    for (int id : molids) {
+                        auto &name = molecules<Tpvec>.at(id).name;
+                        _jj[name] = json({{ "c/M", _round(mean("c/M molecule " + name)) }});
+                    }
                     _roundjson(j,4);
                 }
 
@@ -560,29 +582,32 @@ namespace Faunus {
         template<class Tspace>
             class Multipole : public Analysisbase {
                 const Tspace& spc;
-                struct data { Average<double> Z, Z2, mu, mu2; };
-                std::map<int,data> _map; //!< Molecular moments and their fluctuations
+                std::set<int> ids; //!< Sampled molecule types
 
                 void _sample() override {
                     for (auto &g : spc.groups)
                         if (!g.atomic) {
-                            auto &d = _map[g.id];
-                            auto p = Geometry::toMultipole(g, spc.geo.boundaryFunc);
-                            d.Z += p.charge;
-                            d.mu += p.mulen;
-                            d.Z2 += p.charge*p.charge;
-                            d.mu2 += p.mulen*p.mulen;
+                            auto &name = molecules<typename Tspace::Tpvec>[g.id].name;
+                            auto s = g.currentMoments(spc.geo.distanceFunc);
+                            double Z = s.charge(), mu = s.dipole().norm();
+                            blockavg[name + " Z"] += Z;
+                            blockavg[name + " Z2"] += Z*Z;
+                            blockavg[name + " " + u8::mu] += mu;
+                            blockavg[name + " " + u8::mu + u8::squared] += mu*mu;
+                            ids.insert(g.id);
                         }
                 }
 
                 void _to_json(json &j) const override {
                     json &k = j["molecules"];
-                    for (auto &d : _map)
-                        k[ molecules<typename Tspace::Tpvec>[d.first].name ] = {
-                            {"Z", d.second.Z.avg()}, {"Z2", d.second.Z2.avg()},
-                            {"C", std::pow(d.second.Z.avg(),2)-d.second.Z2.avg()},
-                            {u8::mu, d.second.mu.avg()}, {u8::mu+u8::squared, d.second.mu2.avg()}
+                    for (int id : ids) {
+                        auto &name = molecules<typename Tspace::Tpvec>[id].name;
+                        double Z = mean(name + " Z"), Z2 = mean(name + " Z2");
+                        k[name] = {
+                            {"Z", Z}, {"Z2", Z2}, {"C", Z*Z - Z2},
+                            {u8::mu, mean(name + " " + u8::mu)}, {u8::mu+u8::squared, mean(name + " " + u8::mu + u8::squared)}
                         };
+                    }
                 }
 
                 public:
@@ -596,7 +621,6 @@ namespace Faunus {
             std::string file, sep=" ";
             std::ofstream f;
             std::function<std::vector<double>()> energyFunc;
-            Average<double> uavg; //!< mean energy
             std::vector<std::string> names;
             Table2D<double,double> ehist;  //Density histograms
 
@@ -619,7 +643,9 @@ namespace Faunus {
             inline void _sample() override {
                 auto ulist = energyFunc();
                 double tot = std::accumulate(ulist.begin(), ulist.end(), 0.0);
-                uavg+=tot;
+                blockavg["total"] += tot;
+                for (size_t i=0; i<ulist.size(); i++)
+                    blockavg[names[i]] += ulist[i];
                 f << cnt*steps << sep << tot;
                 for (auto u : ulist)
                     f << sep << u;
@@ -630,7 +656,7 @@ namespace Faunus {
             inline void _to_json(json &j) const override {
                 j = { {"file", file}, {"init",uinit}, {"final", energyFunc()} };
                 if (cnt>0)
-                    j["mean"] = uavg.avg();
+                    j["mean"] = mean("total");
                 _roundjson(j,5);
                 //normalize();
                 //ehist.save( "distofstates.dat" );
@@ -680,6 +706,138 @@ namespace Faunus {
                 }
         }; //!< Save system energy to disk. Keywords: `nstep`, `file`.
 
+        /**
+         * @brief Reduced energies of neighbouring thermodynamic states for MBAR or histogram reweighting
+         *
+         * The system energy is split into parts that scale linearly with a single parameter
+         * (see `Energy::Energybase::components()`) so that the reduced energy of a state with
+         * a different dielectric constant, temperature, Debye length or short-range scaling
+         * can be evaluated from the sampled configuration without a separate simulation.
+         * For each Debye length, the pairwise Coulomb part is replaced by a screened Coulomb
+         * sum evaluated by the nonbonded terms, i.e. with their cut-offs and exclusions.
+         * Unsupported terms are detected by evaluating the parts once on construction.
+         */
+        template<class Tspace>
+            class Reweighting : public Analysisbase {
+                private:
+                    struct State {
+                        double epsr=0;        //!< Dielectric constant (0 = reference)
+                        double T=0;           //!< Temperature in K (0 = reference)
+                        double debyelength=0; //!< Screening length in Å (0 = reference electrostatics)
+                        double epsscale=1;    //!< Scaling of the short-range part
+                    };
+
+                    std::function<void(std::map<std::string,double>&, std::map<double,double>&)> componentFunc;
+                    std::vector<State> states;
+                    std::string file;
+                    std::ofstream f;
+                    double epsr=0;                           //!< Reference dielectric constant
+
+                    static std::string yukawaKey(double debyelength) {
+                        std::ostringstream o;
+                        o << "yukawa " << debyelength;
+                        return o.str();
+                    } //!< Name of the sampled screened Coulomb energy
+
+                    void evaluate(std::map<std::string,double> &u, std::map<double,double> &screened) const {
+                        u = { {"coulomb",0}, {"shortrange",0}, {"other",0} };
+                        screened.clear();
+                        for (auto &s : states)
+                            if (s.debyelength>0)
+                                screened[s.debyelength] = 0;
+                        componentFunc(u, screened);
+                        for (auto &i : screened)
+                            i.second *= pc::lB(epsr); // reference dielectric constant
+                    } //!< Energy parts and screened Coulomb energy (kT) for each Debye length
+
+                    void _sample() override {
+                        std::map<std::string,double> u;
+                        std::map<double,double> uyukawa;
+                        evaluate(u, uyukawa);
+                        for (auto &i : u)
+                            blockavg[i.first] += i.second;
+                        for (auto &i : uyukawa)
+                            blockavg[ yukawaKey(i.first) ] += i.second;
+                        f << cnt*steps << " " << u["coulomb"] + u["shortrange"] + u["other"];
+                        for (auto &s : states) {
+                            double uel = u["coulomb"];
+                            if (s.debyelength>0)
+                                uel = uyukawa[s.debyelength];
+                            if (s.epsr>0)
+                                uel *= epsr / s.epsr; // lB*kT is independent of temperature
+                            double ured = u["other"] + s.epsscale*u["shortrange"] + uel;
+                            if (s.T>0)
+                                ured *= pc::temperature / s.T;
+                            f << " " << ured;
+                        }
+                        f << "\n";
+                    }
+
+                    void _to_json(json &j) const override {
+                        j["file"] = file;
+                        if (epsr>0)
+                            j["epsr"] = epsr;
+                        auto &_j = j["states"] = json::array();
+                        for (auto &s : states) {
+                            json t;
+                            if (s.epsr>0) t["epsr"] = s.epsr;
+                            if (s.T>0) t["temperature"] = s.T;
+                            if (s.debyelength>0) t["debyelength"] = s.debyelength;
+                            if (s.epsscale!=1) t["epsscale"] = s.epsscale;
+                            _j.push_back(t);
+                        }
+                        if (cnt>0) {
+                            for (auto key : {"coulomb", "shortrange", "other"})
+                                j["mean"][key] = mean(key);
+                            std::set<double> debyelengths;
+                            for (auto &s : states)
+                                if (s.debyelength>0)
+                                    debyelengths.insert(s.debyelength);
+                            for (double D : debyelengths)
+                                j["mean"]["yukawa"].push_back( {D, mean(yukawaKey(D))} ); // [debyelength, energy]
+                        }
+                        _roundjson(j,5);
+                    }
+
+                    void _from_json(const json &j) override {
+                        file = MPI::prefix + j.at("file").get<std::string>();
+                        epsr = j.value("epsr", 0.0);
+                        states.clear();
+                        for (auto &i : j.at("states")) {
+                            State s;
+                            s.epsr = i.value("epsr", 0.0);
+                            s.T = i.value("temperature", 0.0);
+                            s.debyelength = i.value("debyelength", 0.0);
+                            s.epsscale = i.value("epsscale", 1.0);
+                            if ( (s.epsr>0 || s.debyelength>0) && epsr<=0 )
+                                throw std::runtime_error("reference 'epsr' required to reweight electrostatics");
+                            states.push_back(s);
+                        }
+                        if (f)
+                            f.close();
+                        f.open(file);
+                        if (!f)
+                            throw std::runtime_error(name + ": cannot open output file " + file);
+                        f << "# step u0";
+                        for (size_t i=0; i<states.size(); i++)
+                            f << " u" << i+1;
+                        f << "\n";
+                    }
+
+                public:
+                    template<class Tenergy>
+                        Reweighting(const json &j, Tspace&, Tenergy &pot) {
+                            name = "reweight";
+                            from_json(j);
+                            componentFunc = [&pot](std::map<std::string,double> &u, std::map<double,double> &screened) {
+                                pot.components(u, screened);
+                            };
+                            std::map<std::string,double> u;
+                            std::map<double,double> screened;
+                            evaluate(u, screened); // throws if a term cannot be reweighted
+                        }
+            }; //!< Reduced energies of neighbouring states. Keywords: `nstep`, `file`, `epsr`, `states`.
+
         class SaveState : public Analysisbase {
             private:
                 std::function<void(std::string)> writeFunc = nullptr;
@@ -767,7 +925,7 @@ namespace Faunus {
                 Table2D<double,Average<double>> hist2;
                 std::string name1, name2, file, file2;
                 double Rhypersphere; // Radius of 2D hypersphere
-                Average<double> V;   // average volume (angstrom^3)
+                double rmax=0;       // largest possible distance; used to project memory use
                 virtual void normalize();
             private:
 
@@ -793,6 +951,11 @@ namespace Faunus {
             public:
                 inline PairFunctionBase(const json &j) { from_json(j); }
 
+                size_t memory() const override {
+                    size_t bins = rmax/dr + 1, node = 4*sizeof(void*); // std::map node overhead
+                    return bins * (node + 2*sizeof(double)) + bins * (node + sizeof(double) + sizeof(Average<double>));
+                } //!< Both histograms, when filled up to `rmax`
+
                 inline virtual ~PairFunctionBase() {
                     normalize();
                     hist.save( MPI::prefix + file );
@@ -812,7 +975,7 @@ namespace Faunus {
                 }
                 if (dim==1)
                     Vr = dr;
-                i.second = i.second/sum * V/Vr;
+                i.second = i.second/sum * mean("V")/Vr; // average volume (angstrom^3)
             }
         }
 
@@ -822,9 +985,10 @@ namespace Faunus {
                 Tspace &spc;
 
                 void _sample() override {
-                    V += spc.geo.getVolume( dim );
-                    for ( auto i = spc.p.begin(); i != spc.p.end(); ++i )
-                        for ( auto j=i; ++j != spc.p.end(); )
+                    blockavg["V"] += spc.geo.getVolume( dim );
+                    auto active = spc.activeParticles();
+                    for ( auto i = active.begin(); i != active.end(); ++i )
+                        for ( auto j=i; ++j != active.end(); )
                             if (
                                     ( i->id==id1 && j->id==id2 ) ||
                                     ( i->id==id2 && j->id==id1 )
@@ -839,6 +1003,7 @@ namespace Faunus {
                 AtomRDF( const json &j, Tspace &spc ) : PairFunctionBase(j), spc(spc) {
                     typedef typename Tspace::Tparticle Tparticle;
                     name = "atomrdf";
+                    rmax = 0.5 * spc.geo.getLength().norm();
 
                     auto it = findName( atoms<Tparticle>, name1 );
                     if ( it == atoms<Tparticle>.end() )
@@ -859,7 +1024,7 @@ namespace Faunus {
                 Tspace &spc;
 
                 void _sample() override {
-                    V += spc.geo.getVolume( dim );
+                    blockavg["V"] += spc.geo.getVolume( dim );
                     for ( auto i = spc.groups.begin(); i != spc.groups.end(); ++i )
                         for ( auto j=i; ++j != spc.groups.end(); )
                             if (
@@ -875,6 +1040,7 @@ namespace Faunus {
                 public:
                 MoleculeRDF( const json &j, Tspace &spc ) : PairFunctionBase(j), spc(spc) {
                     name = "molrdf";
+                    rmax = 0.5 * spc.geo.getLength().norm();
 
                     auto it = findName( molecules<Tpvec>, name1 );
                     if (it == molecules<Tpvec>.end())
@@ -926,7 +1092,6 @@ namespace Faunus {
             Energy::Energybase& pot;
             std::function<double()> getVolume;
             std::function<void(double)> scaleVolume;
-            Average<double> duexp; // < exp(-du/kT) >
 
             void _sample() override {
                 if (fabs(dV)>1e-10) {
@@ -934,7 +1099,7 @@ namespace Faunus {
                     scaleVolume(Vold + dV);
                     double Unew = pot.energy(c);
                     scaleVolume(Vold);
-                    duexp += exp(-(Unew - Uold));
+                    blockavg["exp(-du)"] += exp(-(Unew - Uold));
                     assert(fabs(Uold - pot.energy(c)) < 1e-7);
                 }
             }
@@ -942,7 +1107,7 @@ namespace Faunus {
             void _from_json(const json &j) override { dV = j.at("dV"); }
 
             void _to_json(json &j) const override {
-                double pex = log(duexp.avg()) / dV;
+                double pex = log(mean("exp(-du)")) / dV;
                 j = {
                     {"dV", dV}, {"Pex/mM", pex/1.0_mM},
                     {"Pex/Pa", pex/1.0_Pa}, {"Pex/kT/"+u8::angstrom+u8::cubed, pex}
@@ -1015,12 +1180,25 @@ namespace Faunus {
                     }
                 } //!< save to disk
 
+                auto toMultipole(const Tgroup &g) const {
+                    auto s = g.currentMoments(spc.geo.distanceFunc);
+                    Particle<Charge,Dipole,Quadrupole> m;
+                    m.pos = g.cm;
+                    m.charge = s.charge();
+                    m.mu = s.dipole();
+                    m.Q = s.quadrupole();
+                    m.mulen = m.mu.norm();
+                    if (m.mulen>1e-9)
+                        m.mu.normalize();
+                    return m;
+                } //!< Multipole of group `g` about its mass center from its moment sums
+
                 void _sample() override {
                     for (auto &gi : spc.findMolecules(ids[0]))
                         for (auto &gj : spc.findMolecules(ids[1]))
                             if (gi!=gj) {
-                                auto a = Geometry::toMultipole(gi, spc.geo.boundaryFunc);
-                                auto b = Geometry::toMultipole(gj, spc.geo.boundaryFunc);
+                                auto a = toMultipole(gi);
+                                auto b = toMultipole(gj);
                                 Point R = spc.geo.vdist(gi.cm, gj.cm);
                                 auto &d = m[ to_bin(R.norm(), dr) ];
                                 d.tot += g2g(gi, gj);
@@ -1111,38 +1289,31 @@ namespace Faunus {
         template<class Tspace>
             class PolymerShape : public Analysisbase {
                 Tspace &spc;
-                std::map<int, Average<double>> Rg2, Rg, Re2, Rs, Rs2, Rg2x, Rg2y, Rg2z;
                 std::vector<int> ids; // molecule id's to analyse
 
                 void _to_json(json &j) const override {
                     using namespace u8;
                     json &k = j["molecules"];
-                    for (int i : ids)
-                        k[ molecules<typename Tspace::Tpvec>[i].name ] = {
-                            { bracket("Rg" + squared), Rg2.at(i).avg() },
-                            { bracket("Rg" + squared) + "-" + bracket("Rg") + squared, Rg2.at(i).avg() - std::pow(Rg.at(i).avg(), 2.0) },
-                            { bracket("Re" + squared) + "/" + bracket("Rg" + squared), Re2.at(i).avg() / Rg2.at(i).avg() },
-                            { rootof + bracket("Rg"  + squared), sqrt( Rg2.at(i).avg() ) },
-                            { rootof + bracket("Re"  + squared), sqrt( Re2.at(i).avg() )  },
-                            { rootof + bracket("Rgx" + squared), sqrt( Rg2x.at(i).avg() ) },
-                            { rootof + bracket("Rgy" + squared), sqrt( Rg2y.at(i).avg() ) },
-                            { rootof + bracket("Rgz" + squared), sqrt( Rg2z.at(i).avg() ) }
+                    for (int i : ids) {
+                        auto &name = molecules<typename Tspace::Tpvec>[i].name;
+                        auto avg = [&](const std::string &key) { return mean(name + " " + key); };
+                        k[name] = {
+                            { bracket("Rg" + squared), avg("Rg2") },
+                            { bracket("Rg" + squared) + "-" + bracket("Rg") + squared, avg("Rg2") - std::pow(avg("Rg"), 2.0) },
+                            { bracket("Re" + squared) + "/" + bracket("Rg" + squared), avg("Re2") / avg("Rg2") },
+                            { rootof + bracket("Rg"  + squared), sqrt( avg("Rg2") ) },
+                            { rootof + bracket("Re"  + squared), sqrt( avg("Re2") )  },
+                            { rootof + bracket("Rgx" + squared), sqrt( avg("Rg2x") ) },
+                            { rootof + bracket("Rgy" + squared), sqrt( avg("Rg2y") ) },
+                            { rootof + bracket("Rgz" + squared), sqrt( avg("Rg2z") ) }
                         };
+                    }
                 }
 
                 Point vectorgyrationRadiusSquared(typename Tspace::Tgroup &g) const {
-                    double sum = 0;
-                    Point t, r2(0, 0, 0);
-                    for (auto &i : g) {
-                        t = i.pos - g.cm;
-                        spc.geo.boundary(t);
-                        r2.x() += i.mw * t.x() * t.x();
-                        r2.y() += i.mw * t.y() * t.y();
-                        r2.z() += i.mw * t.z() * t.z();
-                        sum += i.mw;
-                    }
-                    assert(sum > 0 && "Zero molecular weight not allowed.");
-                    return r2 * (1. / sum);
+                    auto s = g.currentMoments(spc.geo.distanceFunc);
+                    assert(s.m > 0 && "Zero molecular weight not allowed.");
+                    return s.gyration().diagonal();
                 }
 
                 void _sample() override {
@@ -1152,15 +1323,13 @@ namespace Faunus {
                                 Point r2 = vectorgyrationRadiusSquared(g);
                                 double rg2 = r2.sum();
                                 double re2 = spc.geo.sqdist( g.begin()->pos, g.end()->pos );
-                                Rg[i] += sqrt(rg2);
-                                Rg2[i] += rg2;
-                                Re2[i] += re2; //end-2-end squared
-                                Rg2x[i] += r2.x();
-                                Rg2y[i] += r2.y();
-                                Rg2z[i] += r2.z();
-                                double rs = Re2[i].avg() / Rg2[i].avg(); // fluctuations in shape factor
-                                Rs[i] += rs;
-                                Rs2[i] += rs * rs;
+                                auto &name = molecules<typename Tspace::Tpvec>[i].name;
+                                blockavg[name + " Rg"] += sqrt(rg2);
+                                blockavg[name + " Rg2"] += rg2;
+                                blockavg[name + " Re2"] += re2; //end-2-end squared
+                                blockavg[name + " Rg2x"] += r2.x();
+                                blockavg[name + " Rg2y"] += r2.y();
+                                blockavg[name + " Rg2z"] += r2.z();
                             }
                 }
 
@@ -1191,6 +1360,7 @@ namespace Faunus {
                                         if (it.key()=="multipole") push_back<Multipole<Tspace>>(it.value(), spc);
                                         if (it.key()=="multipoledist") push_back<MultipoleDistribution<Tspace>>(it.value(), spc);
                                         if (it.key()=="polymershape") push_back<PolymerShape<Tspace>>(it.value(), spc);
+                                        if (it.key()=="reweight") push_back<Reweighting<Tspace>>(it.value(), spc, pot);
                                         if (it.key()=="savestate") push_back<SaveState>(it.value(), spc);
                                         if (it.key()=="systemenergy") push_back<SystemEnergy>(it.value(), pot);
                                         if (it.key()=="virtualvolume") push_back<VirtualVolume>(it.value(), spc, pot);
@@ -1207,6 +1377,14 @@ namespace Faunus {
                 for (auto i : this->vec) i->sample();
             }
 
+            json memory() const {
+                json j = json::object();
+                for (auto i : this->vec)
+                    if (i->memory()>0)
+                        j[i->name] = _round( i->memory()/1e6 );
+                return j;
+            } //!< Estimated memory use of each analysis (MB)
+
         }; //!< Aggregates analysis
 
         /** @brief Example analysis */
@@ -7,6 +7,7 @@
 #include <string>
 #include <map>
 #include <regex>
+#include <cstdint>
 
 #include "average.h"
 
@@ -571,9 +572,11 @@ namespace Faunus
      * @brief Container for data between pairs
      *
      * Symmetric, dynamic NxN matrix for storing data
-     * about pairs. Set values with `set()`. If `triangular==true`
-     * the memory usage is reduced but introduces an `if`-statement
-     * upon access.
+     * about pairs. Set values with `set()`. Elements are kept in
+     * a single block allocated with `Eigen::aligned_allocator` and rows padded
+     * to a multiple of `padding` elements, so that row starts of e.g. `double`
+     * matrices are aligned for vectorized loads. If `triangular==true`, indices are sorted upon access
+     * so that only the lower triangle is read.
      *
      * ~~~ cpp
      *     int i=2,j=3; // particle type, for example
@@ -586,41 +589,46 @@ namespace Faunus
     template<class T, bool triangular=false>
         class PairMatrix {
             private:
+                static constexpr size_t padding=4; // row stride is a multiple of this
                 T __val; // default value when resizing
-                std::vector<std::vector<T>> m;
+                size_t n=0, _stride=0;
+                std::vector<T, Eigen::aligned_allocator<T>> m; // row-major, n x stride
             public:
-                void resize(size_t n) {
-                    m.resize(n);
-                    for (size_t i=0; i<m.size(); i++)
-                        if (triangular==true)
-                            m[i].resize(i+1, __val);
-                        else
-                            m[i].resize(n, __val);
+                void resize(size_t nnew) {
+                    size_t stride = (nnew + padding - 1) / padding * padding;
+                    decltype(m) tmp(nnew * stride, __val);
+                    for (size_t i=0; i<std::min(n, nnew); i++)
+                        for (size_t j=0; j<std::min(n, nnew); j++)
+                            tmp[i*stride + j] = m[i*_stride + j];
+                    m.swap(tmp);
+                    n = nnew;
+                    _stride = stride;
                 }
 
                 PairMatrix(size_t n=0, T val=T()) : __val(val) {
                     resize(n);
                 }
 
-                auto size() const { return m.size(); }
+                auto size() const { return n; }
+                size_t stride() const { return _stride; } //!< Padded row length
+                const T* data() const { return m.data(); } //!< Contiguous storage; element (i,j) at `i*stride()+j`
 
                 const T& operator()(size_t i, size_t j) const {
                     if (triangular==true)
                         if (j>i)
                             std::swap(i,j);
-                    assert(i < m.size());
-                    assert(j < m[i].size());
-                    return m[i][j];
+                    assert(i < n);
+                    assert(j < n);
+                    return m[i*_stride + j];
                 }
 
                 void set(size_t i, size_t j, T val) {
                     if (j>i)
                         std::swap(i, j);
-                    if (i>=m.size())
+                    if (i>=n)
                         resize(i+1);
-                    if (triangular==false)
-                        m[j][i] = val;
-                    m[i][j] = val;
+                    m[j*_stride + i] = val;
+                    m[i*_stride + j] = val;
                 }
         };
 #ifdef DOCTEST_LIBRARY_INCLUDED
@@ -652,6 +660,20 @@ namespace Faunus
                     CHECK(m(i,j)==3.1);
         }
 
+        SUBCASE("padding and resize") {
+            PairMatrix<double> m;
+            m.set(i,j,12.1);
+            CHECK(m.stride()==4);
+            m.set(4,0,1.0); // grow beyond first padded row
+            CHECK(m.size()==5);
+            CHECK(m.stride()==8);
+            CHECK(m(i,j)==12.1);
+            CHECK(m(0,4)==1.0);
+            CHECK(m.data()[3*m.stride()+2]==12.1);
+            for (size_t k=0; k<m.size(); k++) // row starts are aligned
+                CHECK( reinterpret_cast<std::uintptr_t>(m.data() + k*m.stride()) % 16 == 0 );
+        }
+
         SUBCASE("triangular matrix") {
             PairMatrix<double,true> m;
             m.set(i,j,12.1);
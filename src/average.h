@@ -1,5 +1,10 @@
 #pragma once
 
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <json.hpp>
+
 namespace Faunus
 {
 
@@ -67,6 +72,124 @@ namespace Faunus
       bool operator<( const Average &a ) const { return avg() < a.avg(); } //!< Compare operator
   };
 
+  /**
+   * @brief Compensated (Kahan) summation
+   *
+   * Keeps a running correction so that long sums of small
+   * increments, such as energy changes, do not lose precision.
+   */
+  template<class T=double> struct KahanSum
+  {
+      T sum=0; //!< Sum
+      T c=0;   //!< Running compensation
+
+      KahanSum& operator+=(T x) {
+          T y = x - c;
+          T t = sum + y;
+          c = (t - sum) - y;
+          sum = t;
+          return *this;
+      } //!< Add value to sum
+
+      KahanSum& operator=(T x) {
+          sum = x;
+          c = 0;
+          return *this;
+      } //!< Assign value
+
+      operator T() const { return sum; } //!< Static cast operator
+  };
+
+  /**
+   * @brief Streaming block average with error estimate for correlated data
+   *
+   * Values are recursively averaged pairwise (Flyvbjerg and Petersen,
+   * doi:10.1063/1.457480) while streaming so that only one running average
+   * and one pending value per block level are kept, i.e. O(log N) memory.
+   * The error of the mean is taken from the first block level where the estimate
+   * plateaus, and the statistical inefficiency, @f$ s = 2\tau_{int} @f$,
+   * from its ratio to the naive (uncorrelated) error.
+   */
+  template<class T=double> class BlockAverage
+  {
+      private:
+          struct Level {
+              Average<T> stats;      //!< Statistics of block averages on this level
+              T pending=0;           //!< Unpaired value waiting for the next
+              bool haspending=false;
+          };
+          std::vector<Level> levels;
+
+          static double variance(const Average<T> &a) {
+              double m = a.avg();
+              return std::max(0.0, a.sqsum/static_cast<double>(a.cnt) - m*m);
+          }
+
+          double levelError(size_t k) const {
+              auto &a = levels[k].stats;
+              return std::sqrt( variance(a) / (a.cnt-1) );
+          } //!< Error of the mean estimated from blocks on level k
+
+      public:
+          unsigned int minblocks=16; //!< Minimum number of blocks in an error estimate
+
+          void add(T x) {
+              for (size_t k=0; ; k++) {
+                  if (k==levels.size())
+                      levels.emplace_back();
+                  auto &l = levels[k];
+                  l.stats += x;
+                  if (!l.haspending) {
+                      l.pending = x;
+                      l.haspending = true;
+                      return;
+                  }
+                  x = (l.pending + x) / 2; // block average passed to next level
+                  l.haspending = false;
+              }
+          } //!< Add value
+
+          BlockAverage& operator+=(T x) {
+              add(x);
+              return *this;
+          } //!< Add value
+
+          void clear() { levels.clear(); } //!< Clear all data
+          bool empty() const { return levels.empty(); } //!< True if empty
+          unsigned long long int size() const { return empty() ? 0 : levels[0].stats.cnt; } //!< Number of samples
+          size_t numlevels() const { return levels.size(); } //!< Number of block levels
+          double avg() const { return levels.at(0).stats.avg(); } //!< Average
+
+          double error() const {
+              if (size()<2)
+                  return 0;
+              double e = levelError(0);
+              for (size_t k=0; k+1<levels.size(); k++) {
+                  auto n = levels[k+1].stats.cnt;
+                  if (n<minblocks)
+                      break;
+                  e = std::max(e, levelError(k));
+                  double enext = levelError(k+1);
+                  if (enext <= e*(1+1/std::sqrt(2.0*(n-1)))) // within uncertainty: plateau
+                      return std::max(e, enext);
+              }
+              return e; // not converged; largest estimate
+          } //!< Error of the mean (one standard deviation)
+
+          double inefficiency() const {
+              if (size()<2 || levelError(0)==0)
+                  return 1;
+              return std::pow( error() / levelError(0), 2 );
+          } //!< Statistical inefficiency, i.e. number of steps between uncorrelated samples
+
+          double tau() const { return 0.5*inefficiency(); } //!< Integrated autocorrelation time
+  };
+
+  template<class T>
+      void to_json(nlohmann::json &j, const BlockAverage<T> &a) {
+          j = { {"mean", a.avg()}, {"error", a.error()}, {"tau", a.tau()} };
+      } //!< Mean, error and integrated autocorrelation time
+
 #ifdef DOCTEST_LIBRARY_INCLUDED
     TEST_CASE("[Faunus] Average") {
         Average<double> a;
@@ -91,6 +214,48 @@ namespace Faunus
         b = 1.0; // assign from double
         CHECK( b.size()==1 );
     }
+
+    TEST_CASE("[Faunus] BlockAverage") {
+        using doctest::Approx;
+        std::mt19937 rng(1234);
+        std::normal_distribution<double> normal;
+        BlockAverage<double> a, b;
+        double x=0, phi=0.9;
+        int n = 1<<16;
+        for (int i=0; i<n; i++) {
+            a += normal(rng);            // uncorrelated
+            x = phi*x + normal(rng);     // AR(1) with inefficiency (1+phi)/(1-phi)=19
+            b += x;
+        }
+        CHECK( a.size() == n );
+        CHECK( a.numlevels() == 17 );    // log2(n)+1
+        CHECK( a.avg() == Approx(0).epsilon(0.02) );
+        CHECK( a.error()*std::sqrt(n) == Approx(1).epsilon(0.2) );
+        CHECK( a.inefficiency() < 1.5 );
+        CHECK( b.inefficiency() > 10 );
+        CHECK( b.inefficiency() < 30 );
+        CHECK( b.tau() == Approx(0.5*b.inefficiency()) );
+        nlohmann::json j = b;
+        CHECK( j.at("mean").get<double>() == Approx(b.avg()) );
+        CHECK( j.at("error").get<double>() == Approx(b.error()) );
+        CHECK( j.at("tau").get<double>() == Approx(b.tau()) );
+        a.clear();
+        CHECK( a.empty() );
+        CHECK( a.error() == 0 );
+    }
+
+    TEST_CASE("[Faunus] KahanSum") {
+        KahanSum<double> s;
+        double t=0;
+        s = 1.0;
+        t = 1.0;
+        for (int i=0; i<10000; i++) {
+            s += 1e-16;
+            t += 1e-16;
+        }
+        CHECK( t == 1.0 ); // plain summation loses all increments
+        CHECK( double(s) == doctest::Approx(1.0+1e-12).epsilon(1e-14) );
+    }
 #endif
 
 }//namespace
@@ -6,12 +6,15 @@
 #include <cassert>
 #include <cmath>
 #include <array>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
 #include <Eigen/Core>
 
 namespace Faunus {
 
     /**
-     * @brief Cuboidal cell list with periodic boundaries
+     * @brief Cuboidal cell list with periodic or closed boundaries
      *
      * Maps cartesian points to a grid of arbitrary resolution that
      * stores particle index.
@@ -25,42 +28,73 @@ namespace Faunus {
      * - the list of particle index in each grid point is stored in a
      *   `std::set<int>` container.
      *
+     * If `resize()` is given the periodicity of each direction, the grid
+     * is a bounding box of the container: closed directions are not wrapped
+     * and cells may be masked with `mask()` so that empty cells outside
+     * e.g. a sphere or cylinder are skipped by `neighbors()`.
+     * In this mode all cells are at least as wide as the cutoff.
+     *
      * @date Malmo, March 2018
      */
     template<typename CellPoint=Eigen::Vector3i>
         class CellList {
             typedef Eigen::Vector3d Point;
             Point halfbox;
+            Point width;    // cell side length in each direction (angstrom)
             double cellsize=0; // cell side length (angstrom)
+            bool bounded=false; // true if periodicity is given to `resize()`
             std::vector<std::vector<std::vector<std::set<int>>>> cells;
+            std::vector<char> masked; // flat list of masked (skipped) cells
+
+            int flat(const CellPoint &c) const {
+                return (c[0]*(KLM[1]+1) + c[1])*(KLM[2]+1) + c[2];
+            } //!< cell point --> flat index
 
             public:
 
             CellPoint KLM = {0,0,0}; // max cell index K,L,M
+            Eigen::Vector3i pbc = {1,1,1}; // periodic directions
 
             auto& operator[](const CellPoint &c) {
                 return cells[c[0]][c[1]][c[2]];
             } //!< returns set with all index in given cell (complexity: constant)
 
             CellPoint p2c(const Point &p) const {
-                return ((p+halfbox)/cellsize).array().round().template cast<int>();
+                if (!bounded)
+                    return ((p+halfbox)/cellsize).array().round().template cast<int>();
+                CellPoint c = ((p+halfbox).array()/width.array()).floor().template cast<int>();
+                for (int d=0; d<3; d++)
+                    c[d] = std::min(std::max(c[d], 0), int(KLM[d])); // points on or outside the boundary
+                return c;
             } //!< cartesian point --> cell point
 
             Point c2p(const CellPoint &c) const {
-                return (c.template cast<double>()) * cellsize - halfbox;
-            } //!< cell point --> cartesian point
+                if (!bounded)
+                    return (c.template cast<double>()) * cellsize - halfbox;
+                return ((c.template cast<double>().array() + 0.5) * width.array()).matrix() - halfbox;
+            } //!< cell point --> cartesian point (cell center if bounded)
+
+            void insert(int i, const CellPoint &c) {
+                (*this)[c].insert(i);
+                if (!masked.empty())
+                    masked[flat(c)] = false;
+            } //!< insert particle index i in cell; the cell is unmasked
 
             void move(int i, const CellPoint &src, const CellPoint &dst) {
                 assert( (*this)[src].count(i)==1 && "i not present in old cell");
                 assert( (*this)[dst].count(i)==0 && "i already in new cell");
                 (*this)[src].erase(i);
-                (*this)[dst].insert(i);
+                insert(i, dst);
             } //!< move particle index i from one cell to another (complexity: N log N)
 
             void resize(const Point &box, double cutoff) {
                 clear();
+                bounded = false;
+                pbc = {1,1,1};
                 halfbox = 0.5*box;
                 cellsize = cutoff;
+                width.setConstant(cellsize);
+                masked.clear();
                 KLM = (box/cellsize).array().round().template cast<int>();
                 if (KLM.minCoeff()>=3) {
                     cells.resize(KLM[0]+1);
@@ -71,7 +105,53 @@ namespace Faunus {
                     }
                 } else
                     throw std::runtime_error("celllist error: too few grid point - cutoff or box too small");
-            }
+            } //!< Fully periodic grid
+
+            void resize(const Point &box, double cutoff, const Eigen::Vector3i &periodic) {
+                if (cutoff<=0 || box.minCoeff()<=0)
+                    throw std::runtime_error("celllist error: cutoff and box must be positive");
+                clear();
+                bounded = true;
+                pbc = periodic;
+                halfbox = 0.5*box;
+                cellsize = cutoff;
+                for (int d=0; d<3; d++) {
+                    int n = (pbc[d]) ? std::max(1, int(std::floor(box[d]/cutoff)))
+                        : std::max(1, int(std::ceil(box[d]/cutoff)));
+                    width[d] = (pbc[d]) ? box[d]/n : cutoff;
+                    KLM[d] = n-1;
+                }
+                cells.resize(KLM[0]+1);
+                for (auto &k : cells) {
+                    k.resize(KLM[1]+1);
+                    for (auto &l : k)
+                        l.resize(KLM[2]+1);
+                }
+                masked.assign((KLM[0]+1)*(KLM[1]+1)*(KLM[2]+1), false);
+            } //!< Bounding box grid; periodic directions are wrapped, others are not
+
+            template<class Tinside>
+                void mask(Tinside inside) {
+                    if (masked.empty())
+                        return;
+                    CellPoint c;
+                    for (c[0]=0; c[0]<=KLM[0]; c[0]++)
+                        for (c[1]=0; c[1]<=KLM[1]; c[1]++)
+                            for (c[2]=0; c[2]<=KLM[2]; c[2]++) {
+                                bool in = false;
+                                Point center = c2p(c);
+                                for (int i=-1; i<=1 && !in; i++)
+                                    for (int j=-1; j<=1 && !in; j++)
+                                        for (int k=-1; k<=1 && !in; k++)
+                                            if (inside( center + 0.5*Point(i,j,k).cwiseProduct(width) ))
+                                                in = true;
+                                masked[flat(c)] = (!in && (*this)[c].empty());
+                            }
+                } //!< Mask empty cells with no center, face or corner `inside(Point)` the container (bounded only)
+
+            size_t numMasked() const {
+                return std::count(masked.begin(), masked.end(), true);
+            } //!< Number of masked cells
 
             void clear() {
                 for (auto &k : cells)
@@ -84,12 +164,35 @@ namespace Faunus {
                 void update(const Tpvec &p, T getpos = [](auto &i){return i;} ) {
                     clear();
                     for (size_t i=0; i<p.size(); i++)
-                        (*this)[ p2c( getpos(p[i]) ) ].insert(i);
+                        insert(i, p2c( getpos(p[i]) ));
                 }
 
             void neighbors(const Eigen::Vector3i &c, std::vector<int> &index, bool clear=true) const {
                 if (clear)
                     index.clear();
+                if (bounded) {
+                    std::array<std::array<int,3>,3> r; // neighbor cells in each direction
+                    std::array<int,3> n = {{0,0,0}};
+                    for (int d=0; d<3; d++)
+                        for (int s=-1; s<=1; s++) {
+                            int x = c[d] + s;
+                            if (x<0 || x>KLM[d]) {
+                                if (!pbc[d])
+                                    continue; // closed boundary: no wraparound
+                                x = (x<0) ? KLM[d] : 0;
+                            }
+                            if (std::find(r[d].begin(), r[d].begin()+n[d], x) == r[d].begin()+n[d])
+                                r[d][n[d]++] = x; // fewer than three periodic cells
+                        }
+                    for (int i=0; i<n[0]; i++)
+                        for (int j=0; j<n[1]; j++)
+                            for (int k=0; k<n[2]; k++)
+                                if (!masked[(r[0][i]*(KLM[1]+1) + r[1][j])*(KLM[2]+1) + r[2][k]]) {
+                                    auto& s = cells[r[0][i]][r[1][j]][r[2][k]];
+                                    std::copy(s.begin(), s.end(), std::back_inserter(index));
+                                }
+                    return;
+                }
                 int cnt=0;
                 std::array<int,3>
                     k = {{ c[0]-1, c[0], c[0]+1 }},
@@ -136,6 +239,28 @@ namespace Faunus {
         CHECK( index.size()==2 );  // now we're two
         l.neighbors( l.p2c( vec[1] ), index);
         CHECK( index.size()==2 );  // now we're two
+
+        SUBCASE("closed boundaries") {
+            Point box = {10,10,10};
+            l.resize(box, 2.2, {0,0,1}); // e.g. a cylinder along z
+            CHECK( l.KLM==Eigen::Vector3i(4,4,3) ); // ceil(10/2.2) and floor(10/2.2) cells
+            CHECK( l.p2c( {5,5,5} ) == l.KLM );
+            CHECK( l.p2c( {-6,-5,-5} ) == Eigen::Vector3i(0,0,0) );
+
+            vec = {{-4.9,0,-4.9}, {4.9,0,-4.9}, {-4.9,0,4.9}};
+            l.update(vec);
+            l.neighbors( l.p2c( vec[0] ), index);
+            CHECK( index.size()==2 ); // not across x but across z
+            CHECK( std::count(index.begin(), index.end(), 1)==0 );
+
+            l.resize(Point(12,12,12), 2, {0,0,1});
+            l.mask( [](const Point &a){ return a.head<2>().norm()<5; } );
+            CHECK( l.numMasked()==4*6 ); // xy-corners of each z layer
+            l.insert(0, {0,0,0}); // occupied cells are never masked
+            CHECK( l.numMasked()==4*6-1 );
+            l.neighbors( {1,1,0}, index);
+            CHECK( index.size()==1 );
+        }
     }
 #endif
 } // namespace
@@ -108,6 +108,11 @@ namespace Faunus {
                     i = _round(i,n);
     } // round float objects to n number of significant digits
 
+    template<typename T>
+        size_t memsize(const std::vector<T> &v) {
+            return v.capacity() * sizeof(T);
+        } //!< Heap memory allocated by a vector (bytes)
+
     double value_inf(const json &j, const std::string &key) {
         auto it = j.find(key);
         if (it==j.end())
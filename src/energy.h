@@ -7,8 +7,14 @@
 #include "multipole.h"
 #include "penalty.h"
 #include "mpi.h"
+#include "celllist.h"
 #include <Eigen/Dense>
 #include <set>
+#include <map>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifdef ENABLE_POWERSASA
 #include <power_sasa.h>
@@ -23,10 +29,26 @@ namespace Faunus {
                 keys key=NONE;
                 std::string name;
                 std::string cite;
+                bool concurrent=true; //!< False if term must be evaluated after all concurrent terms
+                TimeRelativeOfTotal<std::chrono::microseconds> timer; //!< Time spent in `energy()` when called via `Hamiltonian`
                 virtual double energy(Change&)=0; //!< energy due to change
                 inline virtual void to_json(json &j) const {}; //!< json output
                 inline virtual void sync(Energybase*, Change&) {}
                 inline virtual void init() {} //!< reset and initialize
+                inline virtual size_t memory() const { return 0; } //!< Estimated memory use incl. projected growth (bytes)
+
+                /**
+                 * @brief Add system energy to named parts for reweighting
+                 *
+                 * Parts are `coulomb` (linear in lB), `shortrange` (linear in epsilon) and `other`.
+                 * For each Debye length key in `screened`, terms that evaluate pairwise Coulomb
+                 * interactions add the screened sum, sum z_i z_j exp(-r/D)/r, with unit Bjerrum length.
+                 */
+                inline virtual void components(std::map<std::string,double> &u, std::map<double,double> &screened) {
+                    Change change;
+                    change.all = true;
+                    u["other"] += energy(change);
+                }
         };
 
         void to_json(json &j, const Energybase &base) {
@@ -48,7 +70,14 @@ namespace Faunus {
             double const_inf, eps_surf;
             bool spherical_sum=true;
             bool ipbc=false;
+            bool mpisplit=false;   //!< Distribute k-vectors over MPI ranks running the same system
+            bool tiled=true;       //!< Process particles in cache sized tiles when updating all k-vectors
             int kVectorsInUse=0;
+            int kVectorsTotal=0;   //!< Number of k-vectors before splitting over ranks
+
+            size_t memory() const {
+                return sizeof(double) * (kVectors.size() + Aks.size()) + sizeof(Tcomplex) * (Qion.size() + Qdip.size());
+            } //!< Memory used by k-vector arrays (bytes)
             Point L; //!< Box dimensions
 
             void update(const Point &box) {
@@ -103,7 +132,22 @@ namespace Faunus {
                     Aks.conservativeResize(kVectorsInUse);
                     kVectors.conservativeResize(3,kVectorsInUse);
                 }
+                kVectorsTotal = kVectorsInUse;
+#ifdef ENABLE_MPI
+                if (mpisplit && MPI::mpi.nproc()>1) // keep only this rank's slice
+                    slice(MPI::mpi.rank(), MPI::mpi.nproc());
+#endif
             }
+
+            void slice(int rank, int nproc) {
+                int N = kVectorsInUse;
+                int first = (N*rank)/nproc, n = (N*rank+N)/nproc - first; // cf. `MPI::splitEven`
+                kVectors = kVectors.middleCols(first, n).eval();
+                Aks = Aks.segment(first, n).eval();
+                Qion.resize(n);
+                Qdip.resize(n);
+                kVectorsInUse = n;
+            } //!< Keep only the k-vectors handled by `rank` out of `nproc` ranks
         };
 
         void from_json(const json &j, EwaldData &d) {
@@ -114,13 +158,21 @@ namespace Faunus {
             d.spherical_sum = j.value("spherical_sum", true);
             d.lB = pc::lB( j.at("epsr") );
 	    d.eps_surf = j.value("epss", 0.0);
+            d.mpisplit = j.value("mpisplit", false);
+            d.tiled = j.value("tiled", true);
+#ifndef ENABLE_MPI
+            if (d.mpisplit)
+                throw std::runtime_error("ewald: mpisplit requires MPI support");
+#endif
             d.const_inf = (d.eps_surf < 1) ? 0 : 1; // if unphysical (<1) use epsr infinity for surrounding medium
         }
 
         void to_json(json &j, const EwaldData &d) {
             j = {{"lB", d.lB}, {"ipbc", d.ipbc}, {"epss", d.eps_surf},
                 {"alpha", d.alpha}, {"cutoff", d.rc}, {"kcutoff", d.kc},
-                {"wavefunctions", d.kVectors.cols()}, {"spherical_sum", d.spherical_sum}};
+                {"wavefunctions", d.kVectorsTotal}, {"spherical_sum", d.spherical_sum}, {"tiled", d.tiled}};
+            if (d.mpisplit)
+                j["wavefunctions on this rank"] = d.kVectors.cols();
         }
 
 #ifdef DOCTEST_LIBRARY_INCLUDED
@@ -136,6 +188,7 @@ namespace Faunus {
 
             CHECK(data.ipbc == false);
             CHECK(data.const_inf == 1);
+            CHECK(data.tiled == true);
             CHECK(data.alpha == 0.894427190999916);
             CHECK(data.kVectors.cols() == 2975);
             CHECK(data.Qion.size() == data.kVectors.cols());
@@ -153,35 +206,76 @@ namespace Faunus {
                 typedef typename Tspace::Tpvec::iterator iter;
                 Tspace *spc;
                 Tspace *old=nullptr; // set only if key==NEW at first call to `sync()`
+                mutable Eigen::MatrixX3d pos;  // workspace: positions of a tile
+                mutable Eigen::VectorXd charge; // workspace: charges of a tile
+                mutable Eigen::MatrixXd kr;    // workspace: k.r of a tile (eigenopt only)
 
                 PolicyIonIon(Tspace &spc) : spc(&spc) {}
 
-                void updateComplex(EwaldData &data) const {
+                static size_t tileSize(size_t numk) {
+                    long cache=0;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+                    cache = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+                    if (cache<=0)
+                        cache = 256*1024; // fallback if unknown
+                    return std::max( size_t(16), size_t(cache) / (3*sizeof(double)*std::max(numk, size_t(1))) );
+                } //!< Particles per tile so that k.r, cos and sin of a tile fit in the L2 cache
+
+                void addTile(EwaldData &data, size_t n) const {
+                    if (n==0)
+                        return;
                     if (eigenopt)
                         if (data.ipbc==false) {
-                            auto pos = asEigenMatrix(spc->p.begin(), spc->p.end(), &Tspace::Tparticle::pos); //  Nx3
-                            auto charge = asEigenVector(spc->p.begin(), spc->p.end(), &Tspace::Tparticle::charge); // Nx1
-                            Eigen::MatrixXd kr = pos.matrix() * data.kVectors; // Nx3 * 3xK = NxK
-                            data.Qion.real() = (kr.array().cos().colwise()*charge).colwise().sum();
-                            data.Qion.imag() = kr.array().sin().colwise().sum();
+                            if (kr.rows()!=pos.rows() || kr.cols()!=data.kVectors.cols())
+                                kr.resize( pos.rows(), data.kVectors.cols() ); // allocated once per tile and k-vector count
+                            auto _kr = kr.topRows(n);
+                            _kr.noalias() = pos.topRows(n) * data.kVectors; // n x K, bounded by tile size
+                            data.Qion.real() += ( _kr.array().cos().colwise() * charge.head(n).array() ).colwise().sum().transpose().matrix();
+                            data.Qion.imag() += ( _kr.array().sin().colwise() * charge.head(n).array() ).colwise().sum().transpose().matrix();
                             return;
                         }
                     for (int k=0; k<data.kVectors.cols(); k++) {
                         const Point& kv = data.kVectors.col(k);
                         EwaldData::Tcomplex Q(0,0);
                         if (data.ipbc)
-                            for (auto &i : spc->p)
-                                Q += kv.cwiseProduct(i.pos).array().cos().prod() * i.charge;
+                            for (size_t m=0; m<n; m++)
+                                Q += kv.cwiseProduct( pos.row(m).transpose() ).array().cos().prod() * charge[m];
                         else
-                            for (auto &i : spc->p) {
-                                double dot = kv.dot(i.pos);
-                                Q += i.charge * EwaldData::Tcomplex( std::cos(dot), std::sin(dot) );
+                            for (size_t m=0; m<n; m++) {
+                                double dot = kv.dot( pos.row(m).transpose() );
+                                Q += charge[m] * EwaldData::Tcomplex( std::cos(dot), std::sin(dot) );
                             }
-                        data.Qion[k] = Q;
+                        data.Qion[k] += Q;
+                    }
+                } //!< Add contribution from the first `n` particles of a tile to all k vectors
+
+                void updateComplex(EwaldData &data) const {
+                    size_t tile = 0; // untiled: all active particles in one tile
+                    if (data.tiled)
+                        tile = tileSize( data.kVectors.cols() );
+                    else
+                        for (auto &g : spc->groups)
+                            tile += g.size();
+                    tile = std::max(tile, size_t(1));
+                    if (size_t(pos.rows())!=tile) {
+                        pos.resize(tile, 3);
+                        charge.resize(tile);
+                    }
+                    data.Qion.setZero( data.kVectors.cols() );
+                    size_t n=0;
+                    for (auto &i : spc->activeParticles()) {
+                        pos.row(n) = i.pos.transpose();
+                        charge[n] = i.charge;
+                        if (++n==tile) {
+                            addTile(data, n);
+                            n=0;
+                        }
                     }
-                } //!< Update all k vectors
+                    addTile(data, n);
+                } //!< Update all k vectors, optionally in cache sized tiles of particles
 
-                void updateComplex(EwaldData &data, iter begin, iter end) const {
+                void updateComplex(EwaldData &data, iter begin, iter end, bool positions=true) const {
                     assert(old!=nullptr);
                     assert(spc->p.size() == old->p.size());
                     size_t ibeg = std::distance(spc->p.begin(), begin); // it->index
@@ -189,7 +283,19 @@ namespace Faunus {
                     for (int k=0; k<data.kVectors.cols(); k++) {
                         auto& Q = data.Qion[k];
                         Point q = data.kVectors.col(k);
-                        if (data.ipbc)
+                        if (!positions) // only charges have changed
+                            for (size_t i=ibeg; i<=iend; i++) {
+                                double dq = spc->p[i].charge - old->p[i].charge;
+                                if (dq!=0) {
+                                    if (data.ipbc)
+                                        Q += q.cwiseProduct( spc->p[i].pos ).array().cos().prod() * dq;
+                                    else {
+                                        double dot = q.dot(spc->p[i].pos);
+                                        Q += dq * EwaldData::Tcomplex( std::cos(dot), std::sin(dot) );
+                                    }
+                                }
+                            }
+                        else if (data.ipbc)
                             for (size_t i=ibeg; i<=iend; i++) {
                                 Q +=  q.cwiseProduct( spc->p[i].pos ).array().cos().prod() * spc->p[i].charge;
                                 Q -=  q.cwiseProduct( old->p[i].pos ).array().cos().prod() * old->p[i].charge;
@@ -202,11 +308,12 @@ namespace Faunus {
                                 Q -= old->p[i].charge * EwaldData::Tcomplex( std::cos(_old), std::sin(_old) );
                             }
                     }
-                } //!< Optimized update of k subset. Require access to old positions through `old` pointer
+                } //!< Optimized update of k subset. Require access to old positions through `old` pointer.
+                  //!< If `positions` is false, only charges have changed and only one phase factor per particle is needed
 
                 double selfEnergy(const EwaldData &d) {
                     double E = 0;
-                    for (auto& i : spc->p)
+                    for (auto& i : spc->activeParticles())
                         E += i.charge * i.charge;
                     return -d.alpha*E / std::sqrt(pc::pi) * d.lB;
                 }
@@ -215,7 +322,7 @@ namespace Faunus {
                     if (d.const_inf < 0.5)
                         return 0;
                     Point qr(0,0,0);
-                    for (auto &i : spc->p)
+                    for (auto &i : spc->activeParticles())
                         qr += i.charge*i.pos;
                     return d.const_inf * 2 * pc::pi / ( (2*d.eps_surf+1) * spc->geo.getVolume() ) * qr.dot(qr) * d.lB;
                 }
@@ -242,6 +349,7 @@ namespace Faunus {
             spc.geo  = R"( {"length": 10} )"_json;
             spc.p[0] = R"( {"pos": [0,0,0], "q": 1.0} )"_json;
             spc.p[1] = R"( {"pos": [1,0,0], "q": -1.0} )"_json;
+            spc.groups.emplace_back(spc.p.begin(), spc.p.end()); // system-wide loops visit active group members
 
             PolicyIonIon<Tspace> ionion(spc);
             EwaldData data = R"({
@@ -261,6 +369,55 @@ namespace Faunus {
             CHECK( ionion.selfEnergy(data) == Approx(-1.0092530088080642*data.lB) );
             CHECK( ionion.surfaceEnergy(data) == Approx(0.0020943951023931952*data.lB) );
             CHECK( ionion.reciprocalEnergy(data) == Approx(0.0865107467*data.lB) );
+
+            SUBCASE("k-vector slices") {
+                for (bool ipbc : {false, true}) {
+                    data.ipbc = ipbc;
+                    data.update( spc.geo.getLength() );
+                    ionion.updateComplex( data );
+                    double u = ionion.reciprocalEnergy(data), usum = 0;
+                    for (int rank=0; rank<3; rank++) { // energies of three ranks add up to the serial energy
+                        EwaldData d = data;
+                        d.slice(rank, 3);
+                        ionion.updateComplex( d );
+                        usum += ionion.reciprocalEnergy(d);
+                    }
+                    CHECK( usum == Approx(u) );
+#ifdef ENABLE_MPI
+                    data.mpisplit = true; // the sum over all ranks equals the serial energy
+                    data.update( spc.geo.getLength() );
+                    ionion.updateComplex( data );
+                    CHECK( MPI::reduceDouble(MPI::mpi, ionion.reciprocalEnergy(data)) == Approx(u) );
+                    data.mpisplit = false;
+#endif
+                }
+            }
+
+            SUBCASE("tiles") {
+                Tspace::Tpvec p(200);
+                for (size_t i=0; i<p.size(); i++) {
+                    p[i].pos = Point( std::fmod(0.37*i, 10)-5, std::fmod(0.71*i, 10)-5, std::fmod(0.13*i, 10)-5 );
+                    p[i].charge = (i%2) ? 1 : -1;
+                }
+                spc.p = p;
+                spc.groups.clear();
+                spc.groups.emplace_back(spc.p.begin(), spc.p.end());
+                PolicyIonIon<Tspace, true> eigen(spc);
+                for (bool ipbc : {false, true}) {
+                    data.ipbc = ipbc;
+                    data.tiled = false;
+                    data.update( spc.geo.getLength() );
+                    ionion.updateComplex( data );
+                    double u = ionion.reciprocalEnergy(data);
+                    data.tiled = true; // several tiles as tileSize() is at least 16
+                    ionion.updateComplex( data );
+                    CHECK( ionion.reciprocalEnergy(data) == Approx(u) );
+                    eigen.updateComplex( data );
+                    CHECK( eigen.reciprocalEnergy(data) == Approx(u) );
+                    eigen.updateComplex( data ); // reuses workspace
+                    CHECK( eigen.reciprocalEnergy(data) == Approx(u) );
+                }
+            }
         }
 #endif
 
@@ -276,6 +433,8 @@ namespace Faunus {
                     Ewald(const json &j, Tspace &spc) : policy(spc), spc(spc) {
                         name = "ewald";
                         data = j;
+                        if (data.mpisplit)
+                            concurrent = false; // MPI reductions must not run inside OpenMP tasks
                         init();
                     }
 
@@ -297,15 +456,28 @@ namespace Faunus {
                                     if (change.groups.size()==1) { // exactly one group is moved
                                         auto& d = change.groups[0];
                                         auto& g = spc.groups[d.index];
+                                        bool positions = (d.property & ~Change::CHARGE);
                                         if (d.atoms.size()==1)     // exactly one atom is moved
-                                            policy.updateComplex(data, g.begin()+d.atoms[0], g.begin()+d.atoms[0]);
+                                            policy.updateComplex(data, g.begin()+d.atoms[0], g.begin()+d.atoms[0], positions);
                                         else
-                                            policy.updateComplex(data, g.begin(), g.end());
+                                            policy.updateComplex(data, g.begin(), g.end(), positions);
                                     } else
                                         policy.updateComplex(data);
                                 }
                             }
-                            u = policy.selfEnergy(data) + policy.surfaceEnergy(data) + policy.reciprocalEnergy(data);
+                            double ureci = policy.reciprocalEnergy(data);
+#ifdef ENABLE_MPI
+                            if (data.mpisplit) {
+#ifdef _OPENMP
+                                if (omp_in_parallel())
+                                    throw std::runtime_error(name + ": mpisplit requires openmp sections=false and tasks=false");
+#endif
+                                ureci = MPI::reduceDouble(MPI::mpi, ureci); // sum over k-vector slices
+                            }
+#endif
+                            u = policy.surfaceEnergy(data) + ureci;
+                            if (!change.only(Change::POSITION|Change::ORIENTATION)) // self energy depends on charges only
+                                u += policy.selfEnergy(data);
                         }
                         return u;
                     }
@@ -319,6 +491,16 @@ namespace Faunus {
 
                     } //!< Called after a move is rejected/accepted as well as before simulation
 
+                    void components(std::map<std::string,double> &u, std::map<double,double> &screened) override {
+                        if (!screened.empty())
+                            throw std::runtime_error(name + ": cannot reweight to a Debye length");
+                        Change change;
+                        change.all = true;
+                        u["coulomb"] += energy(change);
+                    } //!< Reciprocal, self and surface energies are all linear in lB
+
+                    size_t memory() const override { return data.memory(); }
+
                     void to_json(json &j) const override {
                         j = data;
                     }
@@ -372,6 +554,7 @@ namespace Faunus {
                     std::set<int> molids; // molecules to act upon
                     std::function<double(const Tparticle&)> func=nullptr; // energy of single particle
                     std::vector<std::string> _names;
+                    int properties=Change::ANYPROPERTY; // particle properties that `func` depends on
 
                     template<class Tparticle>
                         double _energy(const Group<Tparticle> &g) const {
@@ -413,6 +596,8 @@ namespace Faunus {
                             }
                         } else
                             for (auto &d : change.groups) {
+                                if ( !(d.property & properties) ) // potential is unaffected by change
+                                    continue;
                                 auto &g = spc.groups.at(d.index); // check specified groups
                                 if (d.all || COM)  // check all atoms in group
                                     u += _energy(g);
@@ -451,6 +636,7 @@ namespace Faunus {
                 public:
                     Confine(const json &j, Tspace &spc) : base(j,spc) {
                         base::name = "confine";
+                        base::properties = Change::POSITION;
                         k = value_inf(j, "k") * 1.0_kJmol; // get floating point; allow inf/-inf
                         type = m.at( j.at("type") );
 
@@ -508,6 +694,202 @@ namespace Faunus {
                     }
             }; //!< Confine particles to a sub-region of the simulation container
 
+        /**
+         * @brief Scalar field on a regular, orthorhombic 3D grid
+         *
+         * Values are stored with z running fastest, as in the OpenDX
+         * format written by e.g. APBS. Points outside the grid evaluate to zero.
+         */
+        struct RegularGrid {
+            Point origin={0,0,0}, delta={1,1,1};
+            Eigen::Vector3i n={0,0,0}; //!< Number of grid points in each dimension
+            std::vector<double> data;  //!< Values, index `(i*n.y()+j)*n.z()+k`
+
+            double& at(int i, int j, int k) { return data.at( (i*n.y()+j)*n.z()+k ); }
+
+            bool inside(const Point &r) const {
+                Point x = (r-origin).cwiseQuotient(delta);
+                return (x.array()>=0).all() && (x.array()<(n.array()-1).cast<double>()).all();
+            } //!< True if `r` can be interpolated
+
+            double operator()(const Point &r) const {
+                Point x = (r-origin).cwiseQuotient(delta);
+                int i = std::floor(x.x()), j = std::floor(x.y()), k = std::floor(x.z());
+                if (i<0 || j<0 || k<0 || i>=n.x()-1 || j>=n.y()-1 || k>=n.z()-1)
+                    return 0;
+                double fx=x.x()-i, fy=x.y()-j, fz=x.z()-k;
+                const double *v = data.data() + (i*n.y()+j)*n.z()+k; // corner (i,j,k)
+                int dj=n.z(), di=n.y()*n.z();
+                for (int c : {0, 1, dj, dj+1, di, di+1, di+dj, di+dj+1})
+                    if (std::isinf(v[c]))
+                        return v[c]; // avoid 0*inf=NaN in the weights below
+                double c00 = v[0]*(1-fz)     + v[1]*fz;
+                double c01 = v[dj]*(1-fz)    + v[dj+1]*fz;
+                double c10 = v[di]*(1-fz)    + v[di+1]*fz;
+                double c11 = v[di+dj]*(1-fz) + v[di+dj+1]*fz;
+                return ( c00*(1-fy) + c01*fy ) * (1-fx) + ( c10*(1-fy) + c11*fy ) * fx;
+            } //!< Trilinear interpolation at position `r`; infinite if any surrounding point is
+
+            void loadDX(const std::string &file) {
+                std::ifstream f(file);
+                if (!f)
+                    throw std::runtime_error("cannot open grid file " + file);
+                std::string line, word;
+                int ndelta=0;
+                while (std::getline(f, line)) {
+                    std::istringstream in(line);
+                    word.clear();
+                    if (!(in >> word) || word[0]=='#')
+                        continue; // blank or comment line
+                    if (word=="origin") {
+                        if (!(in >> origin.x() >> origin.y() >> origin.z()))
+                            throw std::runtime_error("invalid origin in grid file " + file);
+                    }
+                    else if (word=="delta" && ndelta<3) {
+                        Point d;
+                        if (!(in >> d.x() >> d.y() >> d.z()))
+                            throw std::runtime_error("invalid delta in grid file " + file);
+                        delta[ndelta] = d[ndelta]; // diagonal only
+                        ndelta++;
+                    }
+                    else if (word=="object") {
+                        if (line.find("gridpositions")!=std::string::npos) {
+                            in.str( line.substr(line.find("counts")+6) );
+                            in.clear();
+                            if (!(in >> n.x() >> n.y() >> n.z()) || n.minCoeff()<1)
+                                throw std::runtime_error("invalid grid counts in " + file);
+                        }
+                        else if (line.find("data follows")!=std::string::npos) {
+                            data.resize( n.prod() );
+                            for (auto &i : data)
+                                if (!(f >> i))
+                                    throw std::runtime_error("premature end of grid data in " + file);
+                            break;
+                        }
+                    }
+                }
+                if (data.empty() || ndelta!=3)
+                    throw std::runtime_error("invalid or unsupported OpenDX file " + file);
+            } //!< Load from OpenDX file with orthorhombic grid
+        };
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+        TEST_CASE("[Faunus] RegularGrid") {
+            RegularGrid g;
+            g.n = {2,2,2};
+            g.delta = {1,2,1};
+            g.data.resize(8);
+            for (int i=0; i<2; i++)
+                for (int j=0; j<2; j++)
+                    for (int k=0; k<2; k++)
+                        g.at(i,j,k) = i + 10*j + 100*k; // linear field
+            CHECK( g({0,0,0}) == doctest::Approx(0) );
+            CHECK( g({0.5,1,0.25}) == doctest::Approx(0.5+5+25) );
+            CHECK( g({1.5,0,0}) == 0 ); // outside
+            CHECK( g.inside({0.5,1,0.5}) );
+            CHECK( !g.inside({0.5,-1,0.5}) );
+
+            SUBCASE("OpenDX file") {
+                std::string file = MPI::prefix + "_regulargrid_test.dx"; // rank specific under MPI
+                std::string header =
+                    "# comment\n"
+                    "object 1 class gridpositions counts 2 2 2\n"
+                    "origin -1 0 0\n"
+                    "\n"
+                    "delta 2 0 0\n"
+                    "   \n"
+                    "delta 0 1 0\n"
+                    "delta 0 0 1\n"
+                    "\n"
+                    "object 2 class gridconnections counts 2 2 2\n"
+                    "object 3 class array type double rank 0 items 8 data follows\n";
+                RegularGrid h;
+                std::ofstream(file) << header << "0 100\n10 110\n1 101 11 111\n";
+                h.loadDX(file);
+                CHECK( h.n == Eigen::Vector3i(2,2,2) );
+                CHECK( h.delta == Point(2,1,1) );
+                CHECK( h.origin == Point(-1,0,0) );
+                CHECK( h({0,0.5,0.5}) == doctest::Approx(0.5*1 + 0.5*10 + 0.5*100) );
+
+                std::ofstream(file) << header << "0 100\n10 110\n1 101\n"; // truncated data
+                CHECK_THROWS( RegularGrid().loadDX(file) );
+                std::remove(file.c_str());
+            }
+        }
+#endif
+
+        /**
+         * @brief External potential from a gridded scalar field
+         *
+         * Each atom type may be assigned its own grid, loaded from an
+         * OpenDX file. The grid value is optionally multiplied by the particle
+         * charge, i.e. for electrostatic potentials in units of kT/e.
+         */
+        template<typename Tspace, typename base=ExternalPotential<Tspace>>
+            class ExternalGrid : public base {
+                private:
+                    std::vector<RegularGrid> grids;
+                    std::vector<int> gridindex; // atom id --> grid index; -1 if not affected
+                    json files;
+                    bool charge=true;
+
+                public:
+                    ExternalGrid(const json &j, Tspace &spc) : base(j,spc) {
+                        base::name = "externalgrid";
+                        charge = j.value("charge", true);
+                        base::properties = Change::POSITION | (charge ? Change::CHARGE : 0);
+                        files = j.at("file");
+                        gridindex.resize( atoms<typename base::Tparticle>.size(), -1 );
+
+                        std::map<std::string, int> loaded; // avoid loading the same file twice
+                        auto load = [&](const std::string &file) {
+                            auto it = loaded.find(file);
+                            if (it!=loaded.end())
+                                return it->second;
+                            grids.emplace_back();
+                            grids.back().loadDX(file);
+                            return loaded[file] = int(grids.size())-1;
+                        };
+
+                        if (files.is_string()) { // same grid for all or selected atom types
+                            int k = load(files.get<std::string>());
+                            if (j.count("atoms")==0)
+                                std::fill(gridindex.begin(), gridindex.end(), k);
+                            else
+                                for (int id : names2ids(atoms<typename base::Tparticle>, j.at("atoms").get<std::vector<std::string>>()))
+                                    gridindex.at(id) = k;
+                        } else if (files.is_object()) // one grid per atom type
+                            for (auto it=files.begin(); it!=files.end(); ++it) {
+                                auto ids = names2ids(atoms<typename base::Tparticle>, {it.key()});
+                                gridindex.at(ids.at(0)) = load(it.value());
+                            }
+                        else
+                            throw std::runtime_error(base::name + ": 'file' must be a string or an atom-to-file object");
+
+                        base::func = [this](const typename base::Tparticle &p) {
+                            int k = gridindex[p.id];
+                            if (k<0)
+                                return 0.0;
+                            double u = grids[k](p.pos);
+                            return charge ? p.charge*u : u;
+                        };
+                    }
+
+                    size_t memory() const override {
+                        size_t n = memsize(gridindex);
+                        for (auto &g : grids)
+                            n += memsize(g.data);
+                        return n;
+                    }
+
+                    void to_json(json &j) const override {
+                        j["file"] = files;
+                        j["charge"] = charge;
+                        j["grids"] = grids.size();
+                        base::to_json(j);
+                    }
+            }; //!< External potential from interpolated 3D grids, one per atom type
+
         /*
          * The keys of the `intra` map are group index and the values
          * is a vector of `BondData`. For bonds between groups, fill
@@ -594,6 +976,390 @@ namespace Faunus {
             class Nonbonded : public Energybase {
                 private:
                     double g2gcnt=0, g2gskip=0;
+                    bool chargeonly=false;           //!< Only charges have changed; skip charge independent terms
+
+                    enum PairPart : unsigned char {ALLPARTS, CHARGEPART, EPSILONPART, SCREENEDPART};
+                    PairPart part=ALLPARTS;          //!< Part of the pair energy evaluated by `components()`
+                    double kappa=0;                  //!< Inverse Debye length of `SCREENEDPART`
+
+                    template<typename T>
+                        inline double chargePart(const T &a, const T &b, const Point &r) const {
+                            if (part==EPSILONPART)
+                                return 0;
+                            double u = Potential::chargeDependentPart(pairpot, a, b, r);
+                            if (part==SCREENEDPART && u!=0) { // zero outside the Coulomb cut-off
+                                double d = r.norm();
+                                return a.charge * b.charge * std::exp(-kappa*d) / d;
+                            }
+                            return u;
+                        } //!< Charge dependent pair energy, or the part of it selected by `part`
+
+                    template<typename T>
+                        inline double pairEnergy(const T &a, const T &b, const Point &r) const {
+                            if (chargeonly)
+                                return Potential::chargeDependentPart(pairpot, a, b, r);
+                            if (part!=ALLPARTS)
+                                return (part==EPSILONPART) ? Potential::epsilonLinearPart(pairpot, a, b, r) : chargePart(a, b, r);
+                            return pairpot(a, b, r);
+                        } //!< Pair energy, or only its charge dependent part if `chargeonly` is set
+
+                    std::vector<std::string> sitenames; //!< Atom types with cached electrostatic potential
+                    std::vector<int> sites;          //!< Particle index of each site
+                    std::vector<int> siteindex;      //!< Site number of each particle (-1 if not a site)
+                    std::vector<double> phi;         //!< Potential (energy per unit charge) at each site
+                    double phidev=0;                 //!< Largest deviation between tracked and recomputed potentials
+                    const Nonbonded *oldterm=nullptr; //!< Term of the old state, set by `sync()` if key==NEW
+
+                    double phiPair(const Tspace &s, const typename Tspace::Tparticle &site, const typename Tspace::Tparticle &j) const {
+                        auto a = site;
+                        a.charge = 1;
+                        return Potential::chargeDependentPart(pairpot, a, j, s.geo.vdist(site.pos, j.pos));
+                    } //!< Potential at `site` due to particle `j` in space `s`
+
+                    double sitePotential(int k) const {
+                        double u=0;
+                        auto &i = spc.p[ sites[k] ];
+                        for (auto &g : spc.groups)
+                            for (auto &j : g)
+                                if (&j!=&i)
+                                    u += phiPair(spc, i, j);
+                        return u;
+                    } //!< Potential at site `k` summed over all active particles
+
+                    void initSites() {
+                        auto ids = names2ids(atoms<typename Tspace::Tparticle>, sitenames);
+                        sites.clear();
+                        siteindex.assign( spc.p.size(), -1 );
+                        for (size_t i=0; i<spc.p.size(); i++)
+                            if (std::find(ids.begin(), ids.end(), spc.p[i].id) != ids.end()) {
+                                siteindex[i] = sites.size();
+                                sites.push_back(i);
+                            }
+                        phi.resize( sites.size() );
+                        for (size_t k=0; k<sites.size(); k++)
+                            phi[k] = sitePotential(k);
+                    } //!< Locate sites and calculate their potentials from scratch
+
+                    void updateSites(const Change &change) {
+                        if (change.all || change.dV || change.dNpart || oldterm==nullptr) {
+                            for (size_t k=0; k<sites.size(); k++)
+                                phi[k] = sitePotential(k);
+                            return;
+                        }
+                        std::vector<int> changed; // index of changed particles
+                        for (auto &d : change.groups) {
+                            auto &g = spc.groups.at(d.index);
+                            int offset = std::distance(spc.p.begin(), g.begin());
+                            if (d.all || d.atoms.empty())
+                                for (size_t i=0; i<g.size(); i++)
+                                    changed.push_back(offset+i);
+                            else
+                                for (int i : d.atoms)
+                                    changed.push_back(offset+i);
+                        }
+                        std::vector<char> moved( sites.size(), false ); // sites with changed positions
+                        if (!change.only(Change::CHARGE))
+                            for (int i : changed)
+                                if (siteindex[i]>=0)
+                                    moved[ siteindex[i] ] = true;
+                        auto &old = oldterm->spc;
+                        for (size_t k=0; k<sites.size(); k++) {
+                            if (moved[k])
+                                phi[k] = sitePotential(k);
+                            else {
+                                phi[k] = oldterm->phi[k]; // start from the old state so that repeated calls agree
+                                for (int i : changed)
+                                    if (i!=sites[k])
+                                        phi[k] += phiPair(spc, spc.p[sites[k]], spc.p[i])
+                                            - phiPair(old, old.p[sites[k]], old.p[i]);
+                            }
+                        }
+                    } //!< Site potentials of the old state plus contributions from changed particles (only if key==NEW)
+
+                    int rigidmolid=-1;               //!< Rigid molecule with precomputed interaction grids (-1=off)
+                    double rigidspacing=1, rigidpadding=10, rigidumax=1e3;
+                    typename Tspace::Tpvec rigidatoms; //!< Atoms of the rigid molecule in its body frame
+                    std::vector<RegularGrid> rigidgrids; //!< Body frame energy of a probe, for each atom type
+
+                    Eigen::Quaterniond alignRigid(const typename Tspace::Tgroup &g) const {
+                        Eigen::Matrix3d H = Eigen::Matrix3d::Zero();
+                        auto it = g.begin();
+                        for (auto &a : rigidatoms)
+                            H += a.pos * spc.geo.vdist((it++)->pos, g.cm).transpose();
+                        Eigen::JacobiSVD<Eigen::Matrix3d> svd(H, Eigen::ComputeFullU | Eigen::ComputeFullV);
+                        Eigen::Matrix3d D = Eigen::Matrix3d::Identity();
+                        if ( (svd.matrixV() * svd.matrixU().transpose()).determinant() < 0 )
+                            D(2,2) = -1;
+                        return Eigen::Quaterniond( svd.matrixV() * D * svd.matrixU().transpose() );
+                    } //!< Rotation from body frame to the current orientation of `g` (Kabsch)
+
+                    void initRigid() {
+                        auto mols = spc.findMolecules(rigidmolid);
+                        if (mols.begin()==mols.end())
+                            throw std::runtime_error(name + ": no active rigid molecules found");
+                        auto &ref = *mols.begin(); // defines the body frame
+                        rigidatoms.assign( ref.begin(), ref.end() );
+                        double R=0;
+                        for (auto &a : rigidatoms) {
+                            a.pos = spc.geo.vdist(a.pos, ref.cm);
+                            R = std::max(R, a.pos.norm());
+                        }
+                        for (auto &g : spc.findMolecules(rigidmolid)) {
+                            if (g.size()!=rigidatoms.size() ||
+                                    !std::equal(g.begin(), g.end(), rigidatoms.begin(), [](auto &a, auto &b){ return a.id==b.id; }))
+                                throw std::runtime_error(name + ": rigidgrid molecules must have identical atoms");
+                            g.orientation = alignRigid(g);
+                        }
+
+                        int n = 2*int(std::ceil( (R+rigidpadding) / rigidspacing )) + 1;
+                        if ( 2*(R+rigidpadding) > 0.5*spc.geo.getLength().minCoeff() )
+                            throw std::runtime_error(name + ": rigidgrid extent 2(R+padding) exceeds half the box");
+                        std::set<int> types;
+                        for (auto &p : spc.p) {
+                            types.insert(p.id);
+                            if (p.charge != atoms<typename Tspace::Tparticle>.at(p.id).p.charge)
+                                throw std::runtime_error(name + ": rigidgrid requires charges to match the atom list");
+                        }
+                        rigidgrids.assign( atoms<typename Tspace::Tparticle>.size(), RegularGrid() );
+                        for (int t : types) {
+                            auto &grid = rigidgrids[t];
+                            grid.n = {n,n,n};
+                            grid.delta = {rigidspacing, rigidspacing, rigidspacing};
+                            grid.origin = -0.5*(n-1)*grid.delta;
+                            grid.data.resize( n*n*n );
+                            auto probe = atoms<typename Tspace::Tparticle>[t].p;
+                            probe.id = t;
+#pragma omp parallel for firstprivate(probe) schedule (runtime)
+                            for (int m=0; m<n*n*n; m++) {
+                                probe.pos = grid.origin + grid.delta.cwiseProduct( Point(m/(n*n), (m/n)%n, m%n) );
+                                double u=0;
+                                for (auto &a : rigidatoms)
+                                    u += pairpot(a, probe, a.pos-probe.pos);
+                                grid.data[m] = (u > rigidumax) ? pc::infty : u; // overlap; interpolation returns infinity
+                            }
+                        }
+                    } //!< Define body frame, orient rigid groups and tabulate probe energies around the molecule
+
+                    double rigidParticle(const typename Tspace::Tgroup &g, const typename Tspace::Tparticle &j) {
+                        auto &grid = rigidgrids[j.id];
+                        if (!grid.data.empty()) {
+                            Point x = g.orientation.conjugate() * spc.geo.vdist(j.pos, g.cm); // to body frame
+                            if (grid.inside(x))
+                                return grid(x);
+                        }
+                        double u=0; // outside grid: explicit summation
+                        for (auto &i : g)
+                            u += i2i(i,j);
+                        return u;
+                    } //!< Energy of particle `j` with rigid group `g`
+
+                    bool rigid(const typename Tspace::Tgroup &g) const {
+                        return (g.id==rigidmolid && !g.atomic && !chargeonly && part==ALLPARTS);
+                    } //!< True if interactions with `g` should be taken from grids
+
+                    enum ExclusionFlag : unsigned char {EXCLUDE=1, KEEPELECTROSTATICS=2};
+                    struct ExclusionMask {
+                        size_t n=0;                      //!< Molecule size (group capacity)
+                        std::vector<unsigned char> flags; //!< n x n matrix of `ExclusionFlag` bits
+                    };
+                    std::vector<ExclusionMask> exclusions; //!< Intramolecular exclusions for each molecule type
+
+                    void initExclusions() {
+                        exclusions.assign( molecules<typename Tspace::Tpvec>.size(), ExclusionMask() );
+                        std::vector<bool> done( exclusions.size(), false ); // also for types without exclusions
+                        for (auto &g : spc.groups) {
+                            auto &mol = molecules<typename Tspace::Tpvec>.at(g.id);
+                            auto &mask = exclusions.at(g.id);
+                            if (g.atomic || done[g.id])
+                                continue;
+                            done[g.id] = true;
+                            for (auto &b : mol.bonds2)
+                                if (b->exclude) {
+                                    if (mask.flags.empty()) {
+                                        mask.n = g.capacity();
+                                        mask.flags.resize( mask.n*mask.n, 0 );
+                                    }
+                                    unsigned char f = EXCLUDE | (b->keepelectrostatics ? KEEPELECTROSTATICS : 0);
+                                    for (int i : b->index)
+                                        for (int j : b->index)
+                                            if (i!=j) {
+                                                if (i<0 || j<0 || size_t(std::max(i,j))>=mask.n)
+                                                    throw std::runtime_error(name + ": bond index outside molecule " + mol.name);
+                                                auto &k = mask.flags[i*mask.n+j];
+                                                k = (k & EXCLUDE) ? (k & f) : f; // electrostatics are kept only if all bonds keep them
+                                            }
+                                }
+                        }
+                    } //!< Build exclusion masks from bonds with `exclude=true`
+
+                    template<typename T>
+                        inline double i2i_excluded(const T &a, const T &b, unsigned char flag) {
+                            if (flag==0)
+                                return i2i(a,b);
+                            if (flag & KEEPELECTROSTATICS)
+                                return chargePart(a, b, spc.geo.vdist(a.pos, b.pos));
+                            return 0;
+                        } //!< Pair energy subject to an exclusion flag
+
+                    double cellcutoff=0;             //!< Cell list cutoff; zero disables the cell list
+                    CellList<> cells;                //!< Neighbour search for single particle moves
+                    std::vector<Eigen::Vector3i> cellof; //!< Cell of each particle (-1 if not in the list)
+                    std::vector<int> neighbours;     //!< Scratch space for neighbour index
+                    double cellload=0;               //!< Expected number of particles in a cell and its neighbours
+
+                    void initCells() {
+                        cells.resize( spc.geo.getLength(), cellcutoff, spc.geo.periodicity() );
+                        int ncells = (cells.KLM.array()+1).prod();
+                        cellload = double(std::min(27, ncells)) * spc.p.size() / ncells;
+                        cellof.assign( spc.p.size(), Eigen::Vector3i(-1,-1,-1) );
+                        for (auto &g : spc.groups)
+                            for (auto it=g.begin(); it!=g.end(); ++it) {
+                                int i = std::distance(spc.p.begin(), it);
+                                cellof[i] = cells.p2c(it->pos);
+                                cells.insert(i, cellof[i]);
+                            }
+                        cells.mask( [&](const Point &x) { return !spc.geo.collision(x); } );
+                    } //!< Rebuild cell list from active particles and mask empty cells outside the container
+
+                    void updateCells(const Change &change) {
+                        if (cellof.size()!=spc.p.size() || change.dV || change.all || change.dNpart) {
+                            initCells();
+                            return;
+                        }
+                        for (auto &d : change.groups) {
+                            auto &g = spc.groups.at(d.index);
+                            int offset = std::distance(spc.p.begin(), g.begin());
+                            auto update = [&](int i) {
+                                auto c = cells.p2c( spc.p[i].pos );
+                                if (c!=cellof[i]) {
+                                    cells.move(i, cellof[i], c);
+                                    cellof[i] = c;
+                                }
+                            };
+                            if (d.dNpart) {
+                                initCells();
+                                return;
+                            }
+                            if (d.all || d.atoms.empty())
+                                for (size_t i=0; i<g.size(); i++)
+                                    update(offset+i);
+                            else
+                                for (int i : d.atoms)
+                                    update(offset+i);
+                        }
+                    } //!< Move changed particles between cells; rebuild if volume or particle number changed
+
+                    bool mixed=false;                //!< Single precision group-to-group kernel, double precision sums
+                    int validate=0;                  //!< Compare w. double precision every n'th group pair (0=never)
+                    unsigned long long int mixedcnt=0;
+                    Average<double> mixeddev;        //!< Deviation, mixed vs. double precision, relative to the sum of absolute pair energies
+                    std::vector<float> xf, yf, zf, qf; //!< Single precision mirror of positions and charges (SoA)
+                    std::vector<int> idf;            //!< Atom type of each particle in the mirror
+                    Eigen::Vector3f lenf, leninvf;   //!< Box length and inverse; the inverse is zero if not periodic
+
+                    void mirror(int first, int last) {
+                        for (int i=first; i<last; i++) {
+                            auto &a = spc.p[i];
+                            xf[i] = a.pos.x();
+                            yf[i] = a.pos.y();
+                            zf[i] = a.pos.z();
+                            qf[i] = a.charge;
+                            idf[i] = a.id;
+                        }
+                    } //!< Copy particles in index range [first:last[ to single precision arrays
+
+                    void updateMirror(const Change &change) {
+                        if (xf.size()!=spc.p.size() || change.dV || change.all) {
+                            for (auto v : {&xf, &yf, &zf, &qf})
+                                v->resize( spc.p.size() );
+                            idf.resize( spc.p.size() );
+                            mirror( 0, spc.p.size() );
+                            lenf = spc.geo.getLength().template cast<float>();
+                            leninvf = ( lenf.cwiseInverse().array() * spc.geo.periodicity().array().template cast<float>() ).matrix();
+                        }
+                        else
+                            for (auto &d : change.groups) {
+                                auto &g = spc.groups.at(d.index);
+                                int first = std::distance(spc.p.begin(), g.begin());
+                                if (d.all || d.dNpart || d.atoms.empty())
+                                    mirror( first, first + std::distance(g.begin(), g.trueend()) );
+                                else
+                                    for (int i : d.atoms)
+                                        mirror( first+i, first+i+1 );
+                            }
+                    } //!< Refresh single precision particles that changed
+
+                    template<class T=Tpairpot, typename std::enable_if<Potential::hasKernel<T>::value, int>::type=0>
+                        double g2gMixed(const typename Tspace::Tgroup &g1, const typename Tspace::Tgroup &g2) const {
+                            double u=0; // sum in double precision
+                            int i0 = std::distance(spc.p.begin(), g1.begin()), i1 = i0 + g1.size();
+                            int j0 = std::distance(spc.p.begin(), g2.begin()), j1 = j0 + g2.size();
+                            const float *x=xf.data(), *y=yf.data(), *z=zf.data(), *q=qf.data();
+                            const int *id=idf.data();
+                            const float Lx=lenf.x(), Ly=lenf.y(), Lz=lenf.z(), iLx=leninvf.x(), iLy=leninvf.y(), iLz=leninvf.z();
+                            for (int i=i0; i<i1; i++) {
+                                const float xi=x[i], yi=y[i], zi=z[i], qi=q[i];
+                                const int idi=id[i];
+#pragma omp simd reduction (+:u)
+                                for (int j=j0; j<j1; j++) {
+                                    float dx=xi-x[j], dy=yi-y[j], dz=zi-z[j];
+                                    dx -= Lx * std::floor( dx*iLx + 0.5f ); // minimum image; no-op if not periodic
+                                    dy -= Ly * std::floor( dy*iLy + 0.5f );
+                                    dz -= Lz * std::floor( dz*iLz + 0.5f );
+                                    u += pairpot.kernel( idi, id[j], qi*q[j], dx*dx + dy*dy + dz*dz );
+                                }
+                            }
+                            return u;
+                        } //!< Group-to-group energy evaluated in single precision and summed in double precision
+
+                    template<class T=Tpairpot, typename std::enable_if<!Potential::hasKernel<T>::value, int>::type=0>
+                        double g2gMixed(const typename Tspace::Tgroup&, const typename Tspace::Tgroup&) const {
+                            throw std::runtime_error(name + ": pair potential has no single precision kernel");
+                        }
+
+                    double g2gValidated(const typename Tspace::Tgroup &g1, const typename Tspace::Tgroup &g2) {
+                        double u = g2gMixed(g1, g2);
+                        if (validate>0) {
+                            unsigned long long int n;
+#pragma omp atomic capture
+                            n = ++mixedcnt;
+                            if (n % validate == 0) {
+                                double udouble=0, uabs=0;
+                                for (auto &i : g1)
+                                    for (auto &j : g2) {
+                                        double uij = i2i(i,j);
+                                        udouble += uij;
+                                        uabs += std::fabs(uij);
+                                    }
+                                if (uabs>0)
+#pragma omp critical (nonbonded_validate)
+                                    mixeddev += std::fabs(u-udouble) / uabs;
+                            }
+                        }
+                        return u;
+                    } //!< Mixed precision group-to-group energy, occasionally compared with double precision
+
+                    bool domains=false; //!< Spatially ordered, statically scheduled full energy loops
+
+                    double domainEnergy(bool atomiconly) {
+                        double u=0;
+                        auto order = spc.domainOrder();
+                        int n = order.size();
+#pragma omp parallel for reduction (+:u) schedule (static)
+                        for (int a=0; a<n; a++) {
+                            auto &ga = spc.groups[order[a]];
+                            for (int k=1; k<=n/2; k++) { // half shell: each pair once, equal work per row
+                                int b = (a+k) % n;
+                                if (2*k==n && a>b)
+                                    continue;
+                                u += g2g( ga, spc.groups[order[b]] );
+                            }
+                            if (!atomiconly || ga.atomic)
+                                u += g_internal(ga);
+                        }
+                        return u;
+                    } //!< All group-to-group and internal energies; each thread handles neighbouring groups
+
                 protected:
                     typedef typename Tspace::Tgroup Tgroup;
                     double Rc2_g2g=pc::infty;
@@ -601,6 +1367,38 @@ namespace Faunus {
                     void to_json(json &j) const override {
                         j["pairpot"] = pairpot;
                         j["cutoff_g2g"] = std::sqrt(Rc2_g2g);
+                        if (domains)
+                            j["domains"] = true;
+                        if (!sitenames.empty())
+                            j["sitepotential"] = {
+                                { "atoms", sitenames }, { "sites", sites.size() }, { "max deviation", phidev }
+                            };
+                        if (rigidmolid>=0) {
+                            j["rigidgrid"] = {
+                                { "molecule", molecules<typename Tspace::Tpvec>.at(rigidmolid).name },
+                                { "spacing", rigidspacing }, { "padding", rigidpadding }, { "umax", rigidumax }
+                            };
+                            for (auto &g : rigidgrids)
+                                if (!g.data.empty()) {
+                                    j["rigidgrid"]["points"] = g.data.size();
+                                    break;
+                                }
+                        }
+                        if (mixed) {
+                            j["mixedprecision"] = mixed;
+                            if (validate>0) {
+                                j["validate"] = validate;
+                                if (!mixeddev.empty())
+                                    j["validation"] = {
+                                        { "samples", mixeddev.cnt }, { "mean relative deviation", mixeddev.avg() }
+                                    };
+                            }
+                        }
+                        if (cellcutoff>0)
+                            j["celllist"] = {
+                                { "cutoff", cellcutoff }, { "masked", cells.numMasked() },
+                                { "cells", std::vector<int>({cells.KLM[0]+1, cells.KLM[1]+1, cells.KLM[2]+1}) }
+                            };
                     }
 
                     template<typename T>
@@ -617,9 +1415,48 @@ namespace Faunus {
                     template<typename T>
                         inline double i2i(const T &a, const T &b) {
                             assert(&a!=&b && "a and b cannot be the same particle");
-                            return pairpot(a, b, spc.geo.vdist(a.pos, b.pos));
+                            return pairEnergy(a, b, spc.geo.vdist(a.pos, b.pos));
                         }
 
+                    bool useCells(size_t n) const {
+                        return cellcutoff>0 && cellof.size()==spc.p.size() && n>cellload;
+                    } //!< True if the cell list is up to date and cheaper than looping over `n` particles
+
+                    /*
+                     * Energy of particles in `ga` (all or the internal `index`) with the particles of `gb`
+                     * in neighbouring cells, skipping the internal `exclude` index of `gb`. If `ga` and `gb`
+                     * are the same group, pairs among the moved particles (all if `index` is empty) are
+                     * counted once. Both `index` and `exclude` must be sorted.
+                     */
+                    double cellPairs(const Tgroup &ga, const Tgroup &gb, const std::vector<int> &index=std::vector<int>(), const std::vector<int> &exclude=std::vector<int>()) {
+                        double u=0;
+                        std::vector<int> nb; // not the `neighbours` member as this may run in parallel
+                        int a0 = std::distance(spc.p.begin(), ga.begin()), b0 = std::distance(spc.p.begin(), gb.begin());
+                        bool same = (&ga==&gb);
+                        auto moved = [&](int j) { return index.empty() || std::binary_search(index.begin(), index.end(), j); };
+                        auto pairs = [&](int i) {
+                            cells.neighbors(cellof[a0+i], nb);
+                            for (int k : nb) {
+                                int j = k - b0; // internal index in `gb`
+                                if (j<0 || j>=int(gb.size()))
+                                    continue;
+                                if (same) {
+                                    if (j==i || (j<i && moved(j)))
+                                        continue;
+                                } else if (std::binary_search(exclude.begin(), exclude.end(), j))
+                                    continue;
+                                u += i2i( *(ga.begin()+i), *(gb.begin()+j) );
+                            }
+                        };
+                        if (index.empty())
+                            for (int i=0; i<int(ga.size()); i++)
+                                pairs(i);
+                        else
+                            for (int i : index)
+                                pairs(i);
+                        return u;
+                    }
+
                     /*
                      * Internal energy in group, calculating all with all or, if `index`
                      * is given, only a subset. Index specifies the internal index (starting
@@ -628,6 +1465,23 @@ namespace Faunus {
                     double g_internal(const Tgroup &g, const std::vector<int> &index=std::vector<int>()) {
                         using namespace ranges;
                         double u=0;
+                        if (!g.atomic && size_t(g.id)<exclusions.size() && !exclusions[g.id].flags.empty()) {
+                            auto &mask = exclusions[g.id];
+                            auto flag = [&](int i, int j) { return mask.flags[i*mask.n+j]; };
+                            if (index.empty())
+                                for (int i=0; i<int(g.size()); i++)
+                                    for (int j=i+1; j<int(g.size()); j++)
+                                        u += i2i_excluded( *(g.begin()+i), *(g.begin()+j), flag(i,j) );
+                            else
+                                for (int i : index)
+                                    for (int j=0; j<int(g.size()); j++)
+                                        if (j!=i) // moved<->static and moved<->moved, the latter only once
+                                            if (j>i || !std::binary_search(index.begin(), index.end(), j))
+                                                u += i2i_excluded( *(g.begin()+i), *(g.begin()+j), flag(i,j) );
+                            return u;
+                        }
+                        if (useCells(g.size()))
+                            return cellPairs(g, g, index);
                         if (index.empty()) // assume that all atoms have changed
                             for ( auto i = g.begin(); i != g.end(); ++i )
                                 for ( auto j=i; ++j != g.end(); )
@@ -660,14 +1514,36 @@ namespace Faunus {
                         double u=0;
                         auto it = spc.findGroupContaining(i); // iterator to group
                         if (it!=spc.groups.end()) {    // check if i belongs to group in space
+                            int k = &i - &spc.p.front();
+                            if (cellcutoff>0 && cellof.size()==spc.p.size() && spc.groupindex.size()==spc.p.size() && cellof[k][0]>=0) {
+                                cells.neighbors(cellof[k], neighbours); // i with other particles nearby
+                                for (int j : neighbours) {
+                                    auto &g = spc.groups[ spc.groupindex[j] ];
+                                    if (&g!=&(*it))
+                                        if (!cut(g, *it))
+                                            u += i2i(i, spc.p[j]);
+                                }
+                            } else
                             for (auto &g : spc.groups) // i with all other particles
                                 if (&g!=&(*it))        // avoid self-interaction
-                                    if (!cut(g, *it))  // check g2g cut-off
-                                        for (auto &j : g) // loop over particles in other group
-                                            u += i2i(i,j);
-                            for (auto &j : *it)        // i with all particles in own group
-                                if (&j!=&i)
-                                    u += i2i(i,j);
+                                    if (!cut(g, *it)) {// check g2g cut-off
+                                        if (rigid(g))
+                                            u += rigidParticle(g, i);
+                                        else
+                                            for (auto &j : g) // loop over particles in other group
+                                                u += i2i(i,j);
+                                    }
+                            auto &own = *it;
+                            if (!own.atomic && size_t(own.id)<exclusions.size() && !exclusions[own.id].flags.empty()) {
+                                auto &mask = exclusions[own.id];
+                                int k = &i - &*own.begin();
+                                for (int l=0; l<int(own.size()); l++) // i with own group, subject to exclusions
+                                    if (l!=k)
+                                        u += i2i_excluded(i, *(own.begin()+l), mask.flags[k*mask.n+l]);
+                            } else
+                                for (auto &j : own)        // i with all particles in own group
+                                    if (&j!=&i)
+                                        u += i2i(i,j);
                         } else // particle does not belong to any group
                             for (auto &g : spc.groups) // i with all other *active* particles
                                 for (auto &j : g)      // (this will include only active particles)
@@ -687,17 +1563,34 @@ namespace Faunus {
                     using namespace ranges;
                     double u = 0;
                         if (!cut(g1,g2)) {
-                            if ( index.empty() && jndex.empty() ) // if index is empty, assume all in g1 have changed
-                                for (auto &i : g1)
-                                    for (auto &j : g2) {
-                                        u += i2i(i,j);
-                                    }
+                            if ( index.empty() && jndex.empty() ) { // if index is empty, assume all in g1 have changed
+                                if (useCells( std::max(g1.size(), g2.size()) )) // smaller group searches the larger
+                                    u += (g1.size()<=g2.size()) ? cellPairs(g1, g2) : cellPairs(g2, g1);
+                                else if (rigid(g1) || rigid(g2)) {
+                                    auto &a = rigid(g1) ? g1 : g2; // grid of a is used for atoms in b
+                                    auto &b = rigid(g1) ? g2 : g1;
+                                    for (auto &j : b)
+                                        u += rigidParticle(a, j);
+                                }
+                                else if (mixed && !chargeonly && part==ALLPARTS)
+                                    u += g2gValidated(g1, g2);
+                                else
+                                    for (auto &i : g1)
+                                        for (auto &j : g2) {
+                                            u += i2i(i,j);
+                                        }
+                            }
                             else {// only a subset of g1
-                                for (auto i : index)
-                                    for (auto j=g2.begin(); j!=g2.end(); ++j) {
-                                        u += i2i( *(g1.begin()+i), *j);
-                                    }
-                                if ( !jndex.empty() ) {
+                                if (useCells(g2.size()))
+                                    u += cellPairs(g1, g2, index);
+                                else
+                                    for (auto i : index)
+                                        for (auto j=g2.begin(); j!=g2.end(); ++j) {
+                                            u += i2i( *(g1.begin()+i), *j);
+                                        }
+                                if ( !jndex.empty() && useCells(g1.size()) )
+                                    u += cellPairs(g2, g1, jndex, index); // moved2 <-> static1
+                                else if ( !jndex.empty() ) {
                                     auto fixed = view::ints( 0, int(g1.size()) )
                                         | view::remove_if(
                                             [&index](int i){return std::binary_search(index.begin(), index.end(), i);});
@@ -719,16 +1612,106 @@ namespace Faunus {
                         name="nonbonded";
                         pairpot = j;
                         Rc2_g2g = std::pow( j.value("cutoff_g2g", pc::infty), 2);
+                        mixed = j.value("mixedprecision", false);
+                        validate = j.value("validate", 0);
+                        if (mixed && !Potential::hasKernel<Tpairpot>::value)
+                            throw std::runtime_error(name + ": mixedprecision requires a pair potential with a single precision kernel");
+                        domains = j.value("domains", domains);
+                        sitenames = j.value("sitepotential", sitenames);
+                        if (!sitenames.empty()) {
+                            if (!Potential::chargeLinear(pairpot))
+                                throw std::runtime_error(name + ": sitepotential requires electrostatics of the form q_i*q_j*f(r)");
+                            if (Rc2_g2g<pc::infty)
+                                throw std::runtime_error(name + ": sitepotential cannot be combined with cutoff_g2g");
+                            initSites();
+                        }
+                        initExclusions();
+                        if (!sitenames.empty())
+                            for (auto &mask : exclusions)
+                                if (!mask.flags.empty())
+                                    throw std::runtime_error(name + ": sitepotential cannot be combined with exclusions");
+                        if (j.count("rigidgrid")) {
+                            auto &_j = j.at("rigidgrid");
+                            rigidmolid = names2ids(molecules<typename Tspace::Tpvec>, {_j.at("molecule").get<std::string>()}).at(0);
+                            rigidspacing = _j.value("spacing", rigidspacing);
+                            rigidpadding = _j.value("padding", rigidpadding);
+                            rigidumax = _j.value("umax", rigidumax);
+                            if (molecules<typename Tspace::Tpvec>.at(rigidmolid).atomic)
+                                throw std::runtime_error(name + ": rigidgrid requires a molecular group");
+                            initRigid();
+                        }
+                        if (j.count("celllist")) {
+                            cellcutoff = j.at("celllist").at("cutoff").get<double>();
+                            if (rigidmolid>=0)
+                                throw std::runtime_error(name + ": celllist cannot be combined with rigidgrid");
+                            for (auto &a : atoms<typename Tspace::Tparticle>)
+                                for (auto &b : atoms<typename Tspace::Tparticle>) {
+                                    auto p1 = a.p, p2 = b.p; // end-to-end if spherocylinders
+                                    if (p1.charge==0) p1.charge=1;
+                                    if (p2.charge==0) p2.charge=1;
+                                    for (double f : {1.001, 1.5, 2.0, 5.0})
+                                        if (pairpot(p1, p2, Point(f*cellcutoff, 0, 0)) != 0)
+                                            throw std::runtime_error(name + ": pair potential between " + a.name + " and "
+                                                    + b.name + " extends beyond the celllist cutoff");
+                                }
+                            initCells();
+                        }
+                    }
+
+                    void init() override {
+                        if (!sitenames.empty())
+                            initSites();
+                        if (rigidmolid>=0)
+                            for (auto &g : spc.findMolecules(rigidmolid))
+                                g.orientation = alignRigid(g);
+                        if (cellcutoff>0)
+                            initCells();
                     }
 
+                    void sync(Energybase *basePtr, Change &change) override {
+                        if (cellcutoff>0)
+                            updateCells(change);
+                        if (mixed)
+                            updateMirror(change);
+                        if (!sitenames.empty()) {
+                            auto other = dynamic_cast<decltype(this)>(basePtr);
+                            assert(other);
+                            if (other->key==OLD)
+                                oldterm = other; // give NEW access to OLD potentials and space for site updates
+                            phi = other->phi;
+                        }
+                    } //!< Update cell list and copy site potentials after the particles were synched
+
                     double energy(Change &change) override {
                         using namespace ranges;
                         double u=0;
 
                         if (!change.empty()) {
 
+                            // if only charges changed, both old and new states skip the same,
+                            // charge independent terms which therefore cancel in the energy change
+                            chargeonly = change.only(Change::CHARGE);
+                            if (chargeonly && rigidmolid>=0) // grids assume charges from the atom list
+                                throw std::runtime_error(name + ": rigidgrid cannot be combined with charge changing moves");
+
+                            if (cellcutoff>0)
+                                updateCells(change);
+
+                            if (mixed)
+                                updateMirror(change);
+
+                            if (!sitenames.empty()) {
+                                if (key==NEW)
+                                    updateSites(change);
+                                else if (change.all) // validate tracked potentials
+                                    for (size_t k=0; k<sites.size(); k++)
+                                        phidev = std::max( phidev, std::fabs(sitePotential(k)-phi[k]) );
+                            }
+
                             if (change.dV) {
-#pragma omp parallel for reduction (+:u) schedule (dynamic)
+                                if (domains)
+                                    return domainEnergy(true);
+#pragma omp parallel for reduction (+:u) schedule (runtime)
                                 for ( auto i = spc.groups.begin(); i < spc.groups.end(); ++i ) {
                                     for ( auto j=i; ++j != spc.groups.end(); )
                                         u += g2g( *i, *j );
@@ -740,7 +1723,9 @@ namespace Faunus {
 
                             // did everything change?
                             if (change.all) {
-#pragma omp parallel for reduction (+:u) schedule (dynamic)
+                                if (domains)
+                                    return domainEnergy(false);
+#pragma omp parallel for reduction (+:u) schedule (runtime)
                                 for ( auto i = spc.groups.begin(); i < spc.groups.end(); ++i ) {
                                     for ( auto j=i; ++j != spc.groups.end(); )
                                         u += g2g( *i, *j );
@@ -754,8 +1739,13 @@ namespace Faunus {
                             if (change.groups.size()==1 && !change.dNpart) {
                                 auto& d = change.groups[0];
                                 auto gindex = spc.groups.at(d.index).to_index(spc.p.begin()).first;
-                                if (d.atoms.size()==1) // exactly one atom has moved
-                                    return i2all(spc.p.at(gindex+d.atoms[0]));
+                                if (d.atoms.size()==1) { // exactly one atom has moved
+                                    int i = gindex+d.atoms[0];
+                                    if (chargeonly && !sitenames.empty())
+                                        if (siteindex[i]>=0) // O(1) energy from cached potential
+                                            return spc.p[i].charge * phi[ siteindex[i] ];
+                                    return i2all(spc.p.at(i));
+                                }
                                 auto& g1 = spc.groups.at(d.index);
                                 for (auto &g2 : spc.groups)
                                     if (&g1 != &g2)
@@ -765,64 +1755,542 @@ namespace Faunus {
                                 return u;
                             }
 
-                            //
-                            if (change.dNpart) {
-                                auto moved = change.touchedGroupIndex(); // index of moved groups
-                                std::vector<int> Moved;
-                                for (auto i: moved)
-                                    Moved.push_back(i);
-                                std::sort( Moved.begin(), Moved.end() );
-                                auto fixed = view::ints( 0, int(spc.groups.size()) )
-                                    | view::remove_if(
-                                            [&Moved](int i){return std::binary_search(Moved.begin(), Moved.end(), i);}
-                                            ); // index of static groups
-                                for ( auto cg1 = change.groups.begin(); cg1 < change.groups.end() ; ++cg1 ) { // Loop over all changed groups
-                                    std::vector<int> ifiltered, jfiltered;
-                                    for (auto i: cg1->atoms) {
-                                        if ( i < spc.groups.at(cg1->index).size() )
-                                            ifiltered.push_back(i);
-                                    }
-                                    if ( !( cg1->dNpart && ifiltered.empty() ) ) // Skip if particles are removed
-                                        for ( auto j : fixed) {
-                                            u += g2g( spc.groups.at(cg1->index), spc.groups[j], ifiltered, jfiltered );
-                                    }
-                                    for ( auto cg2 = cg1; ++cg2 != change.groups.end(); ) {
-                                        for (auto i: cg2->atoms)
-                                            if ( i < spc.groups.at(cg2->index).size() )
-                                                jfiltered.push_back(i);
-                                        if ( !( (cg1->dNpart && ifiltered.empty()) && (cg2->dNpart && jfiltered.empty()) ) ) //Skip if particles are removed from both
-                                            u += g2g( spc.groups.at(cg1->index),  spc.groups.at(cg2->index), ifiltered, jfiltered );
-                                        jfiltered.clear();
+                            // several groups changed, possibly with partial and/or
+                            // a varying number of particles (cluster moves, speciation)
+                            std::vector<bool> moved( spc.groups.size(), false ); // bitmap of moved groups
+                            std::vector<std::vector<int>> index( change.groups.size() ); // changed atoms in each moved group
+                            std::vector<char> whole( change.groups.size(), false ), skip( change.groups.size(), false );
+                            for ( size_t k=0; k<change.groups.size(); k++ ) {
+                                auto &d = change.groups[k];
+                                auto &g = spc.groups.at(d.index);
+                                moved[d.index] = true;
+                                for (int i : d.atoms)
+                                    if ( i < int(g.size()) ) // removed atoms are beyond the end of the group
+                                        index[k].push_back(i);
+                                std::sort( index[k].begin(), index[k].end() );
+                                if (d.dNpart)
+                                    skip[k] = index[k].empty(); // only removals in this state
+                                else
+                                    whole[k] = ( d.all || d.atoms.empty() );
+                            }
+
+                            for ( size_t k=0; k<change.groups.size(); k++ ) {
+                                auto &g1 = spc.groups[ change.groups[k].index ];
+                                if (!skip[k]) {
+                                    // moved<->static
+                                    for ( size_t j=0; j<spc.groups.size(); j++ )
+                                        if (!moved[j]) {
+                                            if (whole[k])
+                                                u += g2g( g1, spc.groups[j] );
+                                            else
+                                                u += g2g( g1, spc.groups[j], index[k] );
+                                        }
+                                    // internal
+                                    if (change.groups[k].internal) {
+                                        if (whole[k])
+                                            u += g_internal(g1);
+                                        else
+                                            u += g_internal(g1, index[k]);
                                     }
-                                    if ( ifiltered.size() != 0 )
-                                        u += g_internal( spc.groups.at( cg1->index ), ifiltered );
                                 }
-                                return u;
+                                // moved<->moved, each pair only once
+                                for ( size_t l=k+1; l<change.groups.size(); l++ ) {
+                                    auto &g2 = spc.groups[ change.groups[l].index ];
+                                    if (skip[k] && skip[l])
+                                        continue;
+                                    if (whole[k] || whole[l])
+                                        u += g2g( g1, g2 );
+                                    else if (skip[k])
+                                        u += g2g( g2, g1, index[l] );
+                                    else if (skip[l])
+                                        u += g2g( g1, g2, index[k] );
+                                    else
+                                        u += g2g( g1, g2, index[k], index[l] );
+                                }
                             }
+                        }
+                        return u;
+                    }
 
-                            auto moved = change.touchedGroupIndex(); // index of moved groups
-                            auto fixed = view::ints( 0, int(spc.groups.size()) )
-                                | view::remove_if(
-                                        [&moved](int i){return std::binary_search(moved.begin(), moved.end(), i);}
-                                        ); // index of static groups
+                    size_t memory() const override {
+                        size_t n = memsize(sites) + memsize(siteindex) + memsize(phi)
+                            + memsize(rigidatoms) + memsize(xf) + memsize(yf) + memsize(zf) + memsize(qf) + memsize(idf);
+                        for (auto &m : exclusions)
+                            n += memsize(m.flags);
+                        for (auto &g : rigidgrids)
+                            n += memsize(g.data);
+                        if (cellcutoff>0)
+                            n += memsize(cellof) + spc.p.size()*4*sizeof(int) // set nodes (approximate)
+                                + (cells.KLM.array()+1).prod()*sizeof(std::set<int>);
+                        return n;
+                    } //!< Site potentials, exclusions, rigid body grids, cell list and single precision mirror
+
+                    double systemEnergy() {
+                        double u=0;
+#pragma omp parallel for reduction (+:u) schedule (runtime)
+                        for ( auto i = spc.groups.begin(); i < spc.groups.end(); ++i ) {
+                            for ( auto j=i; ++j != spc.groups.end(); )
+                                u += Nonbonded::g2g( *i, *j ); // bypass cached overrides
+                            u += g_internal(*i);
+                        }
+                        return u;
+                    } //!< Energy of all active particles w. current `chargeonly` and `part` settings
 
-                            // moved<->moved
-                            for ( auto i = moved.begin(); i != moved.end(); ++i ) {
-                                for ( auto j=i; ++j != moved.end(); )
-                                    u += g2g( spc.groups[*i], spc.groups[*j] );
-                            }
+                    /*
+                     * The parts are evaluated by the ordinary group loops and hence subject to the
+                     * same group cut-off, cell list and exclusions as the energy. Charge independent
+                     * potentials that are not proportional to epsilon, e.g. hard spheres and WCA,
+                     * are added to `other` and are not scaled.
+                     */
+                    void components(std::map<std::string,double> &u, std::map<double,double> &screened) override {
+                        if (!Potential::chargeLinear(pairpot))
+                            throw std::runtime_error(name + ": reweighting requires charge linear pair potentials");
+                        bool _chargeonly = chargeonly;
+                        chargeonly = false;
+                        double utot = systemEnergy();
+                        part = CHARGEPART;
+                        double uel = systemEnergy();
+                        part = EPSILONPART;
+                        double ueps = systemEnergy();
+                        part = SCREENEDPART;
+                        for (auto &i : screened) {
+                            kappa = 1/i.first;
+                            i.second += systemEnergy();
+                        }
+                        part = ALLPARTS;
+                        chargeonly = _chargeonly;
+                        u["coulomb"] += uel;
+                        u["shortrange"] += ueps;
+                        u["other"] += utot - uel - ueps;
+                    } //!< Split into charge dependent (linear in lB), epsilon linear and remaining parts
 
-                            // moved<->static
-                            for ( auto i : moved)
-                                for ( auto j : fixed)
-                                    u += g2g(spc.groups[i], spc.groups[j]);
+            }; //!< Nonbonded, pair-wise additive energy term
 
-                            // more todo!
-                        }
-                        return u;
+#ifdef DOCTEST_LIBRARY_INCLUDED
+        TEST_CASE("[Faunus] Nonbonded")
+        {
+            using doctest::Approx;
+            typedef Space<Geometry::Cuboid, Particle<Charge>> Tspace;
+            typedef typename Tspace::Tpvec Tpvec;
+            auto atombackup = atoms<Tspace::Tparticle>;
+            auto molbackup = molecules<Tpvec>;
+            atoms<Tspace::Tparticle> = R"([ {"A": {"r": 1.0, "sigma": 2.0, "eps": 0.5}} ])"_json.get<decltype(atombackup)>();
+            molecules<Tpvec> = R"([ {"M": {"atomic": false}} ])"_json.get<decltype(molbackup)>();
+
+            Tspace spc;
+            spc.geo = R"( {"length": 40} )"_json;
+            for (int k=0; k<4; k++) { // four molecules with three charged atoms each
+                Tpvec p(3);
+                for (int i=0; i<3; i++) {
+                    p[i].id = 0;
+                    p[i].charge = (i==1) ? -1.0 : 0.5+0.1*k;
+                    p[i].pos = Point(8.0*k-12, 1.5*i, 0.3*k);
+                }
+                spc.push_back(0, p);
+            }
+            Nonbonded<Tspace, Potential::Coulomb> nb(R"( {"coulomb": {"epsr": 80}} )"_json, spc);
+
+            Change all;
+            all.all = true;
+
+            SUBCASE("several groups with partial changes") {
+                Change c; // whole group, one atom, two atoms
+                c.groups.resize(3);
+                c.groups[0].index = 0;
+                c.groups[0].all = true;
+                c.groups[1].index = 1;
+                c.groups[1].atoms = {1};
+                c.groups[2].index = 3;
+                c.groups[2].atoms = {0,2};
+                for (auto &d : c.groups)
+                    d.internal = true;
+
+                double u0 = nb.energy(all), du0 = nb.energy(c);
+                for (auto &a : spc.groups[0])
+                    a.pos += Point(0.5, -0.3, 0.2);
+                spc.groups[1].begin()[1].pos += Point(-1, 0.4, 0.1);
+                spc.groups[3].begin()[0].pos += Point(0.2, 0.9, -0.4);
+                spc.groups[3].begin()[2].pos += Point(-0.7, 0.1, 0.3);
+                double u1 = nb.energy(all), du1 = nb.energy(c);
+                CHECK( du1-du0 == Approx(u1-u0) ); // moved<->moved pairs counted once
+            }
+
+            SUBCASE("speciation") {
+                molecules<Tpvec> = R"([ {"M": {"atomic": false}}, {"salt": {"atoms": ["A"], "atomic": true}} ])"_json.get<decltype(molbackup)>();
+                Tpvec salt(10);
+                for (size_t i=0; i<salt.size(); i++) {
+                    salt[i].id = 0;
+                    salt[i].charge = (i%2) ? -1.0 : 1.0;
+                    spc.geo.randompos(salt[i].pos, random);
+                }
+                spc.push_back(1, salt);
+                Tspace spc2; // trial state
+                spc2.sync(spc, all);
+                Nonbonded<Tspace, Potential::Coulomb> nb1(R"( {"coulomb": {"epsr": 80}} )"_json, spc),
+                    nb2(R"( {"coulomb": {"epsr": 80}} )"_json, spc2);
+
+                Change c; // remove two ions and a molecule while a third molecule moves
+                c.dNpart = true;
+                c.groups.resize(3);
+                c.groups[0].index = 0;
+                c.groups[0].atoms = {1};
+                c.groups[1].index = 2;
+                c.groups[1].all = true;
+                c.groups[2].index = 4;
+                c.groups[2].atoms = {8, 9};
+                c.groups[2].dNpart = true;
+                for (auto &d : c.groups)
+                    d.internal = true;
+                spc2.groups[0].begin()[1].pos += Point(0.8, -0.5, 0.3);
+                spc2.groups[2].deactivate( spc2.groups[2].begin(), spc2.groups[2].end() );
+                spc2.groups[4].deactivate( spc2.groups[4].end()-2, spc2.groups[4].end() );
+                CHECK( spc2.groups[4].size()==8 );
+
+                // removal seen from old to new, and insertion seen from new to old
+                double du = nb2.energy(c) - nb1.energy(c);
+                CHECK( du == Approx( nb2.energy(all) - nb1.energy(all) ) );
+                CHECK( du != Approx(0) );
+            }
+
+            SUBCASE("site potentials") {
+                Tspace spc2; // trial state
+                spc2.sync(spc, all);
+                json in = R"( {"coulomb": {"epsr": 80}, "sitepotential": ["A"]} )"_json;
+                Nonbonded<Tspace, Potential::Coulomb> nb1(in, spc), nb2(in, spc2);
+                nb1.key = Energybase::OLD;
+                nb2.key = Energybase::NEW;
+                nb2.sync(&nb1, all);
+                for (int step=0; step<24; step++) {
+                    Change c;
+                    c.groups.resize(1);
+                    c.groups[0].index = step % 4;
+                    c.groups[0].atoms = { step % 3 };
+                    auto &a = spc2.groups[step % 4].begin()[step % 3];
+                    if (step % 3 == 1) {
+                        a.charge = -a.charge;
+                        c.groups[0].property = Change::CHARGE;
+                    } else
+                        a.pos += Point(0.3*(step%5)-0.6, 0.2, -0.1*(step%4));
+                    double unew = nb2.energy(c);
+                    CHECK( nb2.energy(c) == Approx(unew) ); // repeated evaluations must agree
+                    nb1.energy(c);
+                    if (step % 2 == 0) { // accept
+                        spc.sync(spc2, c);
+                        nb1.sync(&nb2, c);
+                    } else { // reject
+                        spc2.sync(spc, c);
+                        nb2.sync(&nb1, c);
                     }
+                }
+                nb1.energy(all); // compares tracked potentials with recomputed ones
+                json out = nb1;
+                CHECK( out["nonbonded"]["sitepotential"]["max deviation"].get<double>() < 1e-9 );
+            }
 
-            }; //!< Nonbonded, pair-wise additive energy term
+            SUBCASE("rigid grids") {
+                atoms<Tspace::Tparticle>[0].p.charge = 0.5; // probes carry atom list properties...
+                for (auto &a : spc.p)
+                    a.charge = 0.5;                         // ...and so must the rigid molecules
+                Nonbonded<Tspace, Potential::Coulomb> nbg(R"( {"coulomb": {"epsr": 80},
+                    "rigidgrid": {"molecule": "M", "spacing": 0.2, "padding": 8}} )"_json, spc);
+                CHECK( nbg.energy(all) == Approx(nb.energy(all)).epsilon(1e-3) );
+
+                Change c; // rotate one molecule, translate another
+                c.groups.resize(2);
+                c.groups[0].index = 1;
+                c.groups[1].index = 2;
+                c.groups[0].all = c.groups[1].all = true;
+                spc.groups[1].rotate( Eigen::Quaterniond(Eigen::AngleAxisd(1.1, Point(1,2,0).normalized())), spc.geo.boundaryFunc );
+                spc.groups[2].translate( Point(-1.5, 1, 0.5), spc.geo.boundaryFunc );
+                CHECK( nbg.energy(c) == Approx(nb.energy(c)).epsilon(1e-3) );
+                CHECK( nbg.energy(all) == Approx(nb.energy(all)).epsilon(1e-3) );
+
+                c.groups.resize(1);
+                c.groups[0].property = Change::CHARGE;
+                CHECK_THROWS_AS( nbg.energy(c), std::runtime_error );
+
+                spc.p[4].charge = -0.5; // charge differs from atom list
+                CHECK_THROWS_AS( (Nonbonded<Tspace, Potential::Coulomb>(R"( {"coulomb": {"epsr": 80},
+                    "rigidgrid": {"molecule": "M", "spacing": 0.2, "padding": 8}} )"_json, spc)), std::runtime_error );
+                spc.p[4].charge = 0.5;
+                CHECK_THROWS_AS( (Nonbonded<Tspace, Potential::Coulomb>(R"( {"coulomb": {"epsr": 80},
+                    "rigidgrid": {"molecule": "M", "spacing": 1, "padding": 10}} )"_json, spc)), std::runtime_error ); // grid exceeds half box
+            }
+
+            SUBCASE("rigid grid overlap") {
+                RegularGrid g;
+                g.n = {2,2,2};
+                g.data.assign(8, 1.0);
+                g.at(1,1,1) = pc::infty;
+                CHECK( std::isinf( g({0.5,0.5,0.5}) ) );
+                g.at(1,1,1) = 1.0;
+                CHECK( g({0.5,0.5,0.5}) == Approx(1) );
+            }
+
+            SUBCASE("bond exclusions") {
+                typedef Potential::CombinedPairPotential<Potential::CoulombGalore, Potential::LennardJones<Tspace::Tparticle>> Tpairpot;
+                json in = R"( {"coulomb": {"type": "plain", "epsr": 80, "cutoff": 50}, "lennardjones": {"mixing": "LB"}} )"_json;
+                Nonbonded<Tspace, Tpairpot> nbfull(in, spc);
+                molecules<Tpvec>[0].bonds2 = R"( [
+                    {"harmonic": {"index": [0,1], "k": 1, "req": 1.5, "exclude": true, "keepelectrostatics": false}},
+                    {"harmonic": {"index": [1,2], "k": 1, "req": 1.5, "exclude": true}} ] )"_json.get<decltype(molbackup[0].bonds2)>();
+                Nonbonded<Tspace, Tpairpot> nbex(in, spc);
+
+                double u = nbfull.energy(all); // subtract 0-1 fully and the non-electrostatic part of 1-2
+                for (auto &g : spc.groups) {
+                    auto &a = g.begin()[0], &b = g.begin()[1], &c = g.begin()[2];
+                    Point rab = spc.geo.vdist(a.pos, b.pos), rbc = spc.geo.vdist(b.pos, c.pos);
+                    u -= nbfull.pairpot(a, b, rab) + nbfull.pairpot(b, c, rbc)
+                        - Potential::chargeDependentPart(nbfull.pairpot, b, c, rbc);
+                }
+                CHECK( nbex.energy(all) == Approx(u) );
+
+                Change one, two; // single atom and multiple atoms with intramolecular changes
+                one.groups.resize(1);
+                one.groups[0].index = 1;
+                one.groups[0].atoms = {1};
+                two.groups.resize(1);
+                two.groups[0].index = 2;
+                two.groups[0].atoms = {0,1};
+                two.groups[0].internal = true;
+                double u0 = nbex.energy(all), du0 = nbex.energy(one);
+                spc.groups[1].begin()[1].pos += Point(0.4, -0.2, 0.3);
+                double u1 = nbex.energy(all), du1 = nbex.energy(one);
+                CHECK( du1-du0 == Approx(u1-u0) );
+
+                du0 = nbex.energy(two);
+                spc.groups[2].begin()[0].pos += Point(-0.3, 0.5, 0.1);
+                spc.groups[2].begin()[1].pos += Point(0.2, 0.2, -0.6);
+                double u2 = nbex.energy(all);
+                du1 = nbex.energy(two);
+                CHECK( du1-du0 == Approx(u2-u1) );
+            }
+
+            SUBCASE("charge only changes") {
+                typedef Potential::CombinedPairPotential<Potential::CoulombGalore, Potential::LennardJones<Tspace::Tparticle>> Tpairpot;
+                Nonbonded<Tspace, Tpairpot> nblj(R"( {
+                    "coulomb": {"type": "plain", "epsr": 80, "cutoff": 50},
+                    "lennardjones": {"mixing": "LB"} } )"_json, spc);
+                Change c, cany;
+                c.groups.resize(1);
+                c.groups[0].index = 2;
+                c.groups[0].atoms = {1};
+                cany = c;
+                c.groups[0].property = Change::CHARGE;
+                CHECK( c.only(Change::CHARGE) );
+                CHECK( !cany.only(Change::CHARGE) );
+
+                double u0 = nblj.energy(all), du0 = nblj.energy(c);
+                CHECK( std::fabs(nblj.energy(cany)-du0) > 1e-6 ); // Lennard-Jones part is skipped
+                spc.groups[2].begin()[1].charge += 1.3;
+                double u1 = nblj.energy(all), du1 = nblj.energy(c);
+                CHECK( du1-du0 == Approx(u1-u0) );
+            }
+
+            SUBCASE("mixed precision") {
+                typedef Potential::CombinedPairPotential<Potential::CoulombGalore, Potential::LennardJones<Tspace::Tparticle>> Tpairpot;
+                CHECK( Potential::hasKernel<Tpairpot>::value );
+                CHECK( Potential::hasKernel<Potential::WeeksChandlerAndersen<Tspace::Tparticle>>::value );
+                CHECK( !Potential::hasKernel<Potential::HardSphere<Tspace::Tparticle>>::value );
+                CHECK_THROWS( Nonbonded<Tspace, Potential::HardSphere<Tspace::Tparticle>>(R"( {"mixedprecision": true} )"_json, spc) );
+
+                Tspace spc2; // 27 molecules on a lattice
+                spc2.geo = R"( {"length": 30} )"_json;
+                for (int k=0; k<27; k++) {
+                    Tpvec p(3);
+                    for (int i=0; i<3; i++) {
+                        p[i].id = 0;
+                        p[i].charge = (i==1) ? -1.0 : 0.5+0.02*k;
+                        p[i].pos = Point(k%3, (k/3)%3, k/9)*10 + Point(1.5*i-10, 0.1*k-10, 0.2*i-10);
+                    }
+                    spc2.push_back(0, p);
+                }
+                json in = R"( {
+                    "coulomb": {"type": "yukawa", "debyelength": 5, "epsr": 80, "cutoff": 14},
+                    "lennardjones": {"mixing": "LB"} } )"_json;
+                Nonbonded<Tspace, Tpairpot> nbd(in, spc2);
+                in["mixedprecision"] = true;
+                in["validate"] = 1;
+                Nonbonded<Tspace, Tpairpot> nbm(in, spc2);
+
+                Change dV, c;
+                dV.dV = true;
+                c.groups.resize(1);
+                c.groups[0].index = 13;
+                c.groups[0].all = true;
+                for (int step=0; step<3; step++) {
+                    double ud = nbd.energy(all), um = nbm.energy(all);
+                    CHECK( um != ud ); // ...as distances and energies are in single precision
+                    CHECK( um == Approx(ud).epsilon(1e-5) );
+                    CHECK( nbm.energy(dV) == Approx(nbd.energy(dV)).epsilon(1e-5) );
+                    CHECK( nbm.energy(c) == Approx(nbd.energy(c)).epsilon(1e-5) );
+                    spc2.groups[13].translate( Point(2.1, -0.7, 8.3), spc2.geo.boundaryFunc ); // across the boundary
+                    spc2.groups[13].rotate( Eigen::Quaterniond(Eigen::AngleAxisd(0.7, Point(0,1,0))), spc2.geo.boundaryFunc );
+                }
+                json out = nbm;
+                auto &val = out["nonbonded"]["validation"];
+                CHECK( val["samples"].get<double>() > 1000 );
+                CHECK( val["mean relative deviation"].get<double>() < 1e-5 );
+            }
+
+            SUBCASE("energy components") {
+                typedef Potential::CombinedPairPotential<Potential::CoulombGalore, Potential::LennardJones<Tspace::Tparticle>> Tpairpot;
+                json jlj = R"( {
+                    "coulomb": {"type": "plain", "epsr": 80, "cutoff": 10},
+                    "lennardjones": {"mixing": "LB"} } )"_json;
+                Nonbonded<Tspace, Tpairpot> nblj(jlj, spc);
+                Nonbonded<Tspace, Potential::CoulombGalore> nbel(jlj, spc);
+                std::map<std::string,double> u;
+                std::map<double,double> screened = { {1e9,0}, {5,0} }; // unscreened and screened
+                nblj.components(u, screened);
+                CHECK( u["other"] == Approx(0) );
+                CHECK( u["coulomb"] == Approx(nbel.energy(all)) );
+                CHECK( u["coulomb"] + u["shortrange"] == Approx(nblj.energy(all)) );
+                CHECK( std::fabs(u["shortrange"]) > 1e-6 );
+
+                // screened sums use the same pairs as the energy, i.e. within the Coulomb cut-off
+                CHECK( pc::lB(80)*screened[1e9] == Approx(u["coulomb"]) );
+                double uyukawa=0;
+                for (auto i=spc.p.begin(); i!=spc.p.end(); ++i)
+                    for (auto j=i; ++j!=spc.p.end(); ) {
+                        double r = std::sqrt( spc.geo.sqdist(i->pos, j->pos) );
+                        if (r<10)
+                            uyukawa += i->charge * j->charge * std::exp(-r/5) / r;
+                    }
+                CHECK( screened[5] == Approx(uyukawa) );
+
+                // reweighting to half the dielectric constant only scales the coulomb part
+                jlj["coulomb"]["epsr"] = 40;
+                Nonbonded<Tspace, Tpairpot> nblj40(jlj, spc);
+                CHECK( 2*u["coulomb"] + u["shortrange"] == Approx(nblj40.energy(all)) );
+
+                // WCA is not proportional to epsilon and is therefore left unscaled
+                typedef Potential::CombinedPairPotential<Potential::CoulombGalore, Potential::WeeksChandlerAndersen<Tspace::Tparticle>> Twca;
+                jlj["wca"] = {{"mixing", "LB"}};
+                Nonbonded<Tspace, Twca> nbwca(jlj, spc);
+                for (auto &a : spc.groups[1])
+                    a.pos.x() = spc.groups[0].begin()->pos.x() + 1.9; // within the WCA range
+                std::map<std::string,double> uwca;
+                nbwca.components(uwca, screened);
+                CHECK( uwca["shortrange"] == Approx(0) );
+                CHECK( uwca["other"] > 0.1 );
+                CHECK( uwca["coulomb"] + uwca["other"] == Approx(nbwca.energy(all)) );
+
+                std::map<std::string,double> ubase;
+                nblj.Energybase::components(ubase, screened); // base class lumps everything into `other`
+                CHECK( ubase["other"] == Approx(nblj.energy(all)) );
+            }
+
+            SUBCASE("domain ordered loops") {
+                Change dV;
+                dV.dV = true;
+                Nonbonded<Tspace, Potential::Coulomb> nbd(R"( {"coulomb": {"epsr": 80}, "domains": true} )"_json, spc);
+                for (int n=4; n<=5; n++) { // even and odd number of groups
+                    CHECK( nbd.energy(all) == Approx(nb.energy(all)) );
+                    CHECK( nbd.energy(dV) == Approx(nb.energy(dV)) );
+                    spc.push_back(0, Tpvec(spc.groups[0].begin(), spc.groups[0].end()));
+                    spc.groups.back().translate(Point(1, 7, -5), spc.geo.boundaryFunc);
+                }
+            }
+
+            SUBCASE("cell list") {
+                molecules<Tpvec> = R"([ {"M": {"atomic": false}}, {"salt": {"atoms": ["A"], "atomic": true}} ])"_json.get<decltype(molbackup)>();
+                Tpvec salt(60);
+                for (size_t i=0; i<salt.size(); i++) {
+                    salt[i].id = 0;
+                    salt[i].charge = (i%2) ? -1.0 : 1.0;
+                    spc.geo.randompos(salt[i].pos, random);
+                }
+                spc.push_back(1, salt);
+
+                CHECK_THROWS( Nonbonded<Tspace, Potential::Coulomb>(R"( {"coulomb": {"epsr": 80}, "celllist": {"cutoff": 6}} )"_json, spc) );
+                json in = R"( {"coulomb": {"type": "plain", "epsr": 80, "cutoff": 6}} )"_json;
+                Nonbonded<Tspace, Potential::CoulombGalore> nbr(in, spc); // reference without cell list
+                in["celllist"] = {{"cutoff", 6}};
+                CHECK_THROWS( Nonbonded<Tspace, Potential::CoulombGalore>(
+                            R"( {"coulomb": {"type": "plain", "epsr": 80, "cutoff": 6.5}, "celllist": {"cutoff": 6}} )"_json, spc) );
+                Nonbonded<Tspace, Potential::CoulombGalore> nbc(in, spc);
+
+                Change dV, one, group, part, several;
+                dV.dV = true;
+                one.groups.resize(1);
+                one.groups[0].index = 4;
+                one.groups[0].atoms = {17};
+                group.groups.resize(1);
+                group.groups[0].index = 4;
+                group.groups[0].all = group.groups[0].internal = true;
+                part = one;
+                part.groups[0].atoms = {3, 7, 20};
+                part.groups[0].internal = true;
+                several = part;
+                several.groups.resize(2);
+                several.groups[1].index = 1;
+                several.groups[1].atoms = {0, 2};
+
+                auto &g = spc.groups[4];
+                for (int step=0; step<3; step++) {
+                    CHECK( nbc.energy(all) == Approx(nbr.energy(all)) );
+                    CHECK( nbc.energy(dV) == Approx(nbr.energy(dV)) );
+                    for (Change *c : {&one, &group, &part, &several})
+                        CHECK( nbc.energy(*c) == Approx(nbr.energy(*c)) );
+                    for (int i : {3, 7, 17, 20}) // move across cells; `all` updates the cell list
+                        spc.geo.randompos(g.begin()[i].pos, random);
+                    spc.groups[1].begin()[0].pos += Point(4, -3, 2);
+                    spc.geo.boundary(spc.groups[1].begin()[0].pos);
+                }
+            }
+
+            SUBCASE("spherocylinders in cell list") {
+                typedef Space<Geometry::Cuboid, Particle<Charge, Cigar>> Tcspace;
+                typedef typename Tcspace::Tpvec Tcpvec;
+                typedef Potential::SpheroCylinder<Potential::WeeksChandlerAndersen<Tcspace::Tparticle>> Tpairpot;
+                auto catombackup = atoms<Tcspace::Tparticle>;
+                auto cmolbackup = molecules<Tcpvec>;
+                atoms<Tcspace::Tparticle> = R"([ {"C": {"sigma": 2.0, "eps": 1.0, "sclen": 4.0}} ])"_json.get<decltype(catombackup)>();
+                molecules<Tcpvec> = R"([ {"rods": {"atoms": ["C"], "atomic": true}} ])"_json.get<decltype(cmolbackup)>();
+
+                Tcspace cspc;
+                cspc.geo = R"( {"length": 30} )"_json;
+                Tcpvec rods(80, atoms<Tcspace::Tparticle>[0].p);
+                for (auto &a : rods) {
+                    cspc.geo.randompos(a.pos, random);
+                    a.scdir = ranunit(random);
+                }
+                cspc.push_back(0, rods);
+
+                // cell list cutoff is between centers and must include the rod length
+                json in = R"( {"spherocylinder": {"mixing": "LB"}} )"_json;
+                in["celllist"] = {{"cutoff", 6}};
+                CHECK_THROWS( Nonbonded<Tcspace, Tpairpot>(in, cspc) );
+                in["celllist"] = {{"cutoff", 6.5}};
+                Nonbonded<Tcspace, Tpairpot> nbc(in, cspc);
+                in.erase("celllist");
+                Nonbonded<Tcspace, Tpairpot> nbr(in, cspc);
+
+                Change one, part;
+                one.groups.resize(1);
+                one.groups[0].index = 0;
+                one.groups[0].atoms = {11};
+                part = one;
+                part.groups[0].atoms = {2, 11, 40};
+                part.groups[0].internal = true;
+                for (int step=0; step<3; step++) {
+                    CHECK( nbc.energy(all) == Approx(nbr.energy(all)) );
+                    CHECK( nbc.energy(one) == Approx(nbr.energy(one)) );
+                    CHECK( nbc.energy(part) == Approx(nbr.energy(part)) );
+                    for (int i : {2, 11, 40}) {
+                        cspc.geo.randompos(cspc.p[i].pos, random);
+                        cspc.p[i].scdir = ranunit(random);
+                    }
+                }
+                atoms<Tcspace::Tparticle> = catombackup;
+                molecules<Tcpvec> = cmolbackup;
+            }
+
+            atoms<Tspace::Tparticle> = atombackup;
+            molecules<Tpvec> = molbackup;
+        }
+#endif
 
         template<typename Tspace, typename Tpairpot>
             class NonbondedCached : public Nonbonded<Tspace,Tpairpot> {
@@ -850,8 +2318,15 @@ namespace Faunus {
                     }
 
                 public:
+                    size_t memory() const override {
+                        return base::memory() + sizeof(float) * cache.size();
+                    } //!< Group-group energy matrix
+
                     NonbondedCached(const json &j, Tspace &spc) : base(j,spc), spc(spc) {
                         base::name += "EM";
+                        for (auto key : {"celllist", "sitepotential", "rigidgrid", "domains", "mixedprecision"})
+                            if (j.count(key))
+                                throw std::runtime_error(base::name + ": '" + key + "' is not supported");
                         init();
                     }
 
@@ -882,7 +2357,7 @@ namespace Faunus {
                         if (!change.empty()) {
 
                             if (change.all || change.dV) {
-#pragma omp parallel for reduction (+:u) schedule (dynamic)
+#pragma omp parallel for reduction (+:u) schedule (runtime)
                                 for ( auto i = base::spc.groups.begin(); i < base::spc.groups.end(); ++i ) {
                                     for ( auto j=i; ++j != base::spc.groups.end(); )
                                         u += g2g( *i, *j );
@@ -901,23 +2376,20 @@ namespace Faunus {
                                 return u;
                             }
 
-                            auto moved = change.touchedGroupIndex(); // index of moved groups
-                            auto fixed = view::ints( 0, int(base::spc.groups.size()) )
-                                | view::remove_if(
-                                        [&moved](int i){return std::binary_search(moved.begin(), moved.end(), i);}
-                                        ); // index of static groups
+                            std::vector<bool> moved( base::spc.groups.size(), false ); // bitmap of moved groups
+                            for (auto &d : change.groups)
+                                moved[d.index] = true;
 
-                            // moved<->moved
-                            for ( auto i = moved.begin(); i != moved.end(); ++i )
-                                for ( auto j=i; ++j != moved.end(); ) {
+                            auto index = change.touchedGroupIndex(); // sorted index of moved groups
+                            for ( auto i = index.begin(); i != index.end(); ++i ) {
+                                // moved<->moved, each pair only once
+                                for ( auto j=i; ++j != index.end(); )
                                     u += g2g( base::spc.groups[*i], base::spc.groups[*j] );
+                                // moved<->static
+                                for ( size_t j=0; j<base::spc.groups.size(); j++ )
+                                    if (!moved[j])
+                                        u += g2g( base::spc.groups[*i], base::spc.groups[j] );
                             }
-                            // moved<->static
-                            for ( auto i : moved)
-                                for ( auto j : fixed)
-                                    u += g2g(base::spc.groups[i], base::spc.groups[j]);
-
-                            // more todo!
                         }
                         return u;
                     }
@@ -937,6 +2409,22 @@ namespace Faunus {
                     } //!< Copy energy matrix from other
             }; //!< Nonbonded with cached energies (Energy Matrix)
 
+#ifdef DOCTEST_LIBRARY_INCLUDED
+        TEST_CASE("[Faunus] NonbondedCached")
+        {
+            typedef Space<Geometry::Cuboid, Particle<Charge>> Tspace;
+            Tspace spc;
+            spc.geo = R"( {"length": 40} )"_json;
+            json in = R"( {"coulomb": {"type": "plain", "epsr": 80, "cutoff": 6}} )"_json;
+            CHECK_NOTHROW( NonbondedCached<Tspace, Potential::CoulombGalore>(in, spc) );
+            in["celllist"] = {{"cutoff", 6}};
+            CHECK_THROWS( NonbondedCached<Tspace, Potential::CoulombGalore>(in, spc) ); // ignored by cached energies
+            in.erase("celllist");
+            in["domains"] = true;
+            CHECK_THROWS( NonbondedCached<Tspace, Potential::CoulombGalore>(in, spc) );
+        }
+#endif
+
         /**
          * `udelta` is the total change of updating the energy function. If
          * not handled this will appear as an energy drift (which it is!). To
@@ -973,6 +2461,7 @@ namespace Faunus {
                     Penalty(const json &j, Tspace &spc) : spc(spc) {
                         using namespace ReactionCoordinate;
                         name = "penalty";
+                        concurrent = false; // reaction coordinates read shared state and update `coord`
                         f0 = j.value("f0", 0.5);
                         scale = j.value("scale", 0.8);
                         quiet = j.value("quiet", true);
@@ -1032,6 +2521,10 @@ namespace Faunus {
                         }
                      }
 
+                    size_t memory() const override {
+                        return sizeof(int) * histo.size() + sizeof(double) * penalty.size();
+                    } //!< Histogram and penalty tables, fully allocated from bin widths at construction
+
                     virtual ~Penalty() {
                         std::ofstream f1(MPI::prefix + file), f2(MPI::prefix + hisfile);
                         if (f1) f1 << "# " << f0 << " " << samplings << "\n" << penalty.array() - penalty.minCoeff() << endl;
@@ -1123,6 +2616,10 @@ namespace Faunus {
                     buffer.resize( penalty.size()*MPI::mpi.nproc() );
                 }
 
+                size_t memory() const override {
+                    return Base::memory() + sizeof(int) * weights.size() + sizeof(double) * buffer.size();
+                } //!< Including receive buffer for all ranks
+
                 void update(const std::vector<double> &c) override {
                     using namespace Faunus::MPI;
                     double uold = penalty[c];
@@ -1166,6 +2663,424 @@ namespace Faunus {
     }; //!< Penalty function with MPI exchange
 #endif
 
+        /**
+         * @brief Generalized Born implicit solvent
+         *
+         * Polar solvation energy,
+         * @f$ \beta u = -\frac{1}{2}(\lambda_B^{in}-\lambda_B^{out}) \sum_{ij} z_iz_j/f_{ij} @f$ with
+         * @f$ f_{ij}=\sqrt{r_{ij}^2+R_iR_j\exp(-r_{ij}^2/4R_iR_j)} @f$, where the effective
+         * Born radii, @f$R_i@f$, are obtained from pairwise HCT descreening, optionally
+         * rescaled according to OBC-II. Descreening integrals, Born radii and the energy are
+         * cached so that a move only revisits pairs involving moved particles and particles
+         * whose Born radius changed. Use `cutoff` to keep the latter set small; pairs within
+         * the cutoff are then found with a cell list so that a move costs O(1), not O(N).
+         */
+        template<class Tspace>
+            class GeneralizedBorn : public Energybase {
+                private:
+                    typedef typename Tspace::Tparticle Tparticle;
+                    Tspace &spc;
+                    const GeneralizedBorn *oldterm=nullptr; //!< Old state, set by `sync()` if key==NEW
+                    std::vector<double> I, R;         //!< Descreening integrals and Born radii
+                    std::vector<char> active;         //!< Mask of active particles
+                    std::vector<char> flag;           //!< Scratch: MOVED or RESCREENED particles in update
+                    std::vector<int> touched;         //!< Scratch: index of particles with new Born radii
+                    enum : char {MOVED=1, RESCREENED=2};
+                    double u=0;                       //!< Cached solvation energy (kT)
+                    double epsr, epsrin, tau, offset, scale, cutoff2;
+                    bool obc=true;                    //!< Use OBC-II rescaling of HCT radii
+                    bool celllist=true;               //!< Find pairs within a finite `cutoff` with a cell list
+                    std::string model;
+                    Average<double> updated;          //!< Number of particles revisited per move
+                    Average<double> visited;          //!< Number of pair candidates per move
+                    CellList<> cells;                 //!< Active particles binned by `cutoff`
+                    std::vector<Eigen::Vector3i> cellof; //!< Cell of each particle (-1 if not in the list)
+
+                    bool useCells() const {
+                        return celllist && cutoff2<pc::infty;
+                    }
+
+                    void initCells() {
+                        cells.resize( spc.geo.getLength(), std::sqrt(cutoff2), spc.geo.periodicity() );
+                        cellof.assign( spc.p.size(), Eigen::Vector3i(-1,-1,-1) );
+                        for (auto &g : spc.groups)
+                            for (auto it=g.begin(); it!=g.end(); ++it) {
+                                int i = it - spc.p.begin();
+                                cellof[i] = cells.p2c(it->pos);
+                                cells.insert(i, cellof[i]);
+                            }
+                        cells.mask( [&](const Point &x) { return !spc.geo.collision(x); } );
+                    } //!< Rebuild cell list from active particles
+
+                    void updateCells(const Change &change) {
+                        if (!useCells())
+                            return;
+                        if (cellof.size()!=spc.p.size() || change.all || change.dV || change.dNpart) {
+                            initCells();
+                            return;
+                        }
+                        for (auto &d : change.groups) {
+                            auto &g = spc.groups.at(d.index);
+                            int offset = g.begin() - spc.p.begin();
+                            auto update = [&](int i) {
+                                auto c = cells.p2c( spc.p[i].pos );
+                                if (c!=cellof[i]) {
+                                    cells.move(i, cellof[i], c);
+                                    cellof[i] = c;
+                                }
+                            };
+                            if (d.all || d.atoms.empty())
+                                for (int k=0; k<int(g.size()); k++)
+                                    update(offset+k);
+                            else
+                                for (int k : d.atoms)
+                                    update(offset+k);
+                        }
+                    } //!< Move changed particles between cells
+
+                    void neighbours(int i, std::vector<int> &nb) const {
+                        if (useCells())
+                            cells.neighbors(cellof[i], nb);
+                        else {
+                            nb.clear();
+                            for (int j=0; j<int(active.size()); j++)
+                                if (active[j])
+                                    nb.push_back(j);
+                        }
+                    } //!< Active particles that may be within `cutoff` of active particle `i`, incl. `i` itself
+
+                    double rho(const Tparticle &a) const {
+                        return atoms<Tparticle>[a.id].sigma/2 - offset;
+                    } //!< Offset intrinsic radius
+
+                    static double descreen(double r, double rhoi, double sj) {
+                        if (rhoi >= r+sj)
+                            return 0; // j is inside i
+                        double L = 1/std::max(rhoi, std::fabs(r-sj)), U = 1/(r+sj);
+                        double x = L - U + 0.25*r*(U*U - L*L) + 0.5/r*std::log(U/L) + 0.25*sj*sj/r*(L*L - U*U);
+                        if (rhoi < sj-r)
+                            x += 2*(1/rhoi - L); // i is inside j
+                        return 0.5*x;
+                    } //!< HCT descreening of atom i by atom j (1/Å)
+
+                    double pairDescreen(const Tspace &s, int i, int j) const {
+                        double r2 = s.geo.sqdist(s.p[i].pos, s.p[j].pos);
+                        if (r2>cutoff2)
+                            return 0;
+                        return descreen(std::sqrt(r2), rho(s.p[i]), scale*rho(s.p[j]));
+                    } //!< Descreening of i by j in space `s`
+
+                    double bornRadius(int i) const {
+                        double r = rho(spc.p[i]);
+                        if (obc) {
+                            double psi = I[i]*r;
+                            return 1/( 1/r - std::tanh(psi - 0.8*psi*psi + 4.85*psi*psi*psi)/(r+offset) );
+                        }
+                        return 1/( 1/r - I[i] );
+                    } //!< Born radius from descreening integral
+
+                    double pairEnergy(const Tspace &s, const std::vector<double> &radii, int i, int j) const {
+                        double r2 = s.geo.sqdist(s.p[i].pos, s.p[j].pos);
+                        if (r2>cutoff2)
+                            return 0;
+                        double RR = radii[i]*radii[j];
+                        return -tau * s.p[i].charge * s.p[j].charge / std::sqrt( r2 + RR*std::exp(-r2/(4*RR)) );
+                    } //!< Solvation energy of a pair
+
+                    double partialEnergy(const GeneralizedBorn &t, const std::vector<int> &index, const std::vector<char> &mask) const {
+                        double du=0;
+                        std::vector<int> nb;
+                        for (int i : index) {
+                            du += -0.5*tau * t.spc.p[i].charge * t.spc.p[i].charge / t.R[i];
+                            t.neighbours(i, nb);
+                            for (int j : nb)
+                                if (j!=i)
+                                    if (!mask[j] || j>i)
+                                        du += pairEnergy(t.spc, t.R, i, j);
+                        }
+                        return du;
+                    } //!< Energy in state `t` of all pairs and self terms involving the particles in `index` (flagged in `mask`)
+
+                    void updateActive() {
+                        active.assign(spc.p.size(), false);
+                        for (auto &g : spc.groups)
+                            for (auto it=g.begin(); it!=g.end(); ++it)
+                                active[ it - spc.p.begin() ] = true;
+                    } //!< Rebuild mask of active particles
+
+                    void updateAll() {
+                        int n = spc.p.size();
+                        updateActive();
+                        if (useCells())
+                            initCells();
+                        I.assign(n, 0);
+                        R.assign(n, 0);
+                        touched.clear();
+                        std::vector<int> nb;
+                        for (int i=0; i<n; i++)
+                            if (active[i]) {
+                                neighbours(i, nb);
+                                for (int j : nb)
+                                    if (j!=i)
+                                        I[i] += pairDescreen(spc, i, j);
+                                R[i] = bornRadius(i);
+                                touched.push_back(i);
+                            }
+                        u = partialEnergy(*this, touched, active);
+                    } //!< Recompute everything from scratch
+
+                    void update(const Change &change) {
+                        assert(oldterm!=nullptr);
+                        auto &old = oldterm->spc;
+                        int n = spc.p.size();
+                        I = oldterm->I; // start from the old state so that repeated calls agree
+                        R = oldterm->R;
+                        flag.assign(n, 0);
+                        touched.clear();
+                        for (auto &d : change.groups) {
+                            auto &g = spc.groups.at(d.index);
+                            int offset = g.begin() - spc.p.begin();
+                            auto mark = [&](int i) {
+                                if (active[i] && !flag[i]) {
+                                    flag[i] = MOVED;
+                                    touched.push_back(i);
+                                }
+                            };
+                            if (d.all || d.atoms.empty())
+                                for (int k=0; k<int(g.size()); k++)
+                                    mark(offset+k);
+                            else
+                                for (int k : d.atoms)
+                                    mark(offset+k);
+                        }
+                        size_t nmoved = touched.size(), nvisited=0;
+                        std::vector<int> nb, nbold;
+                        for (size_t k=0; k<nmoved; k++) {
+                            int i = touched[k];
+                            I[i] = 0;
+                            neighbours(i, nb);
+                            nvisited += nb.size();
+                            for (int j : nb)
+                                if (j!=i)
+                                    I[i] += pairDescreen(spc, i, j);
+                        }
+                        for (size_t k=0; k<nmoved; k++) { // static particles near old or new positions of moved ones
+                            int j = touched[k];
+                            neighbours(j, nb);
+                            if (useCells()) {
+                                oldterm->neighbours(j, nbold);
+                                nb.insert(nb.end(), nbold.begin(), nbold.end());
+                                std::sort(nb.begin(), nb.end());
+                                nb.erase( std::unique(nb.begin(), nb.end()), nb.end() );
+                            }
+                            nvisited += nb.size();
+                            for (int i : nb)
+                                if (flag[i]!=MOVED) {
+                                    double dI = pairDescreen(spc, i, j) - pairDescreen(old, i, j);
+                                    if (dI!=0) {
+                                        I[i] += dI;
+                                        if (!flag[i]) {
+                                            flag[i] = RESCREENED;
+                                            touched.push_back(i);
+                                        }
+                                    }
+                                }
+                        }
+                        for (int i : touched)
+                            R[i] = bornRadius(i);
+                        updated += touched.size();
+                        visited += nvisited;
+                        u = oldterm->u + partialEnergy(*this, touched, flag) - partialEnergy(*oldterm, touched, flag);
+                    } //!< Radii and energy of the trial state from the old state and the particles near moved ones
+
+                public:
+                    GeneralizedBorn(const json &j, Tspace &spc) : spc(spc) {
+                        name = "generalizedborn";
+                        cite = "doi:10.1002/prot.20033";
+                        epsr = j.at("epsr").get<double>();
+                        epsrin = j.value("epsrin", 1.0);
+                        tau = pc::lB(epsrin) - pc::lB(epsr);
+                        offset = j.value("offset", 0.09);
+                        scale = j.value("scale", 0.8);
+                        cutoff2 = std::pow( j.value("cutoff", pc::infty), 2 );
+                        celllist = j.value("celllist", true);
+                        model = j.value("model", std::string("obc"));
+                        if (model=="obc")
+                            obc = true;
+                        else if (model=="hct")
+                            obc = false;
+                        else
+                            throw std::runtime_error("unknown GB model '" + model + "'");
+                        std::set<int> ids;
+                        for (auto &a : spc.p)
+                            ids.insert(a.id);
+                        for (int id : ids)
+                            if (rho( atoms<Tparticle>.at(id).p ) <= 0)
+                                throw std::runtime_error(name + ": radius of atom " + atoms<Tparticle>.at(id).name
+                                        + " must be larger than offset; check sigma");
+                        init();
+                    }
+
+                    void init() override {
+                        updateAll();
+                    }
+
+                    size_t memory() const override {
+                        size_t n = memsize(I) + memsize(R) + memsize(active);
+                        if (useCells())
+                            n += memsize(cellof) + spc.p.size()*4*sizeof(int) // set nodes (approximate)
+                                + (cells.KLM.array()+1).prod()*sizeof(std::set<int>);
+                        return n;
+                    }
+
+                    double energy(Change &change) override {
+                        if (change.empty())
+                            return 0;
+                        if (key==NEW) {
+                            if (change.all || change.dV || change.dNpart || oldterm==nullptr)
+                                updateAll();
+                            else {
+                                updateCells(change);
+                                update(change);
+                            }
+                        }
+                        return u;
+                    } //!< Total solvation energy; the trial state is updated incrementally
+
+                    void sync(Energybase *basePtr, Change &change) override {
+                        auto other = dynamic_cast<decltype(this)>(basePtr);
+                        assert(other);
+                        if (other->key==OLD)
+                            oldterm = other; // give NEW access to OLD radii and space for incremental updates
+                        I = other->I;
+                        R = other->R;
+                        active = other->active;
+                        u = other->u;
+                        updateCells(change);
+                    } //!< Copy radii and energy and update the cell list after the particles were synched
+
+                    void to_json(json &j) const override {
+                        j = { {"epsr", epsr}, {"epsrin", epsrin}, {"offset", offset}, {"scale", scale},
+                            {"model", model}, {"cutoff", std::sqrt(cutoff2)} };
+                        if (useCells())
+                            j["celllist"] = true;
+                        if (!updated.empty()) {
+                            j["updated particles per move"] = updated.avg();
+                            j["pair candidates per move"] = visited.avg();
+                        }
+                        if (!R.empty()) {
+                            Average<double> Ravg;
+                            for (size_t i=0; i<R.size(); i++)
+                                if (active[i])
+                                    Ravg += R[i];
+                            j["mean Born radius"] = Ravg.avg();
+                        }
+                        _roundjson(j,5);
+                    }
+            }; //!< Generalized Born implicit solvent energy
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+        TEST_CASE("[Faunus] GeneralizedBorn")
+        {
+            using doctest::Approx;
+            typedef Space<Geometry::Cuboid, Particle<Charge>> Tspace;
+            auto backup = atoms<Tspace::Tparticle>;
+            atoms<Tspace::Tparticle> = R"([ {"A": {"r": 2.0}} ])"_json.get<decltype(backup)>();
+
+            auto setup = [](Tspace &spc) {
+                spc.geo = R"( {"length": 100} )"_json;
+                spc.p.resize(3);
+                spc.p[0] = R"( {"id":0, "pos": [0,0,0], "q": 1.0} )"_json;
+                spc.p[1] = R"( {"id":0, "pos": [3,0,0], "q": -1.0} )"_json;
+                spc.p[2] = R"( {"id":0, "pos": [0,4,0], "q": 1.0} )"_json;
+                spc.groups.emplace_back(spc.p.begin(), spc.p.end());
+            };
+            Tspace spc1, spc2;
+            setup(spc1);
+            setup(spc2);
+
+            json j = R"( {"epsr": 80, "model": "hct"} )"_json;
+            json joffset = j;
+            joffset["offset"] = 2.0; // equals the radius of "A"
+            CHECK_THROWS_AS( GeneralizedBorn<Tspace>(joffset, spc1), std::runtime_error );
+            GeneralizedBorn<Tspace> gb1(j, spc1), gb2(j, spc2);
+            gb1.key = Energybase::OLD;
+            gb2.key = Energybase::NEW;
+
+            Change c;
+            c.groups.resize(1);
+            c.groups[0].index = 0;
+            c.groups[0].atoms = {0};
+            gb2.sync(&gb1, c);
+            double uold = gb1.energy(c);
+            CHECK( uold < 0 );
+
+            spc2.p[0].pos = {1,1,0}; // incremental update must match full recalculation
+            double unew = gb2.energy(c);
+            GeneralizedBorn<Tspace> gb3(j, spc2);
+            CHECK( unew == Approx( gb3.energy(c) ) );
+            CHECK( gb1.energy(c) == Approx(uold) ); // old state untouched
+
+            spc2.p[0].pos = spc1.p[0].pos; // reject
+            gb2.sync(&gb1, c);
+            CHECK( gb2.energy(c) == Approx(uold) );
+
+            SUBCASE("accepted and rejected moves with cutoff") {
+                Change all;
+                all.all = true;
+                Tspace s1, s2;
+                s1.geo = R"( {"length": 40} )"_json;
+                s1.p.resize(40);
+                for (size_t i=0; i<s1.p.size(); i++) {
+                    s1.p[i].id = 0;
+                    s1.p[i].charge = (i%2) ? -1.0 : 1.0;
+                    s1.geo.randompos(s1.p[i].pos, random);
+                }
+                s1.groups.emplace_back(s1.p.begin(), s1.p.end());
+                s2.sync(s1, all);
+
+                json jc = R"( {"epsr": 80, "cutoff": 8} )"_json, nocells = jc;
+                nocells["celllist"] = false;
+                GeneralizedBorn<Tspace> g1(jc, s1), g2(jc, s2);
+                g1.key = Energybase::OLD;
+                g2.key = Energybase::NEW;
+                g2.sync(&g1, all);
+                for (int step=0; step<30; step++) {
+                    Change c;
+                    c.groups.resize(1);
+                    c.groups[0].index = 0;
+                    c.groups[0].atoms = { int(random()*40) };
+                    if (step%3==0)
+                        c.groups[0].atoms.push_back( (c.groups[0].atoms[0]+7) % 40 );
+                    for (int i : c.groups[0].atoms) {
+                        s2.p[i].pos += 3*ranunit(random);
+                        s2.geo.boundary(s2.p[i].pos);
+                    }
+                    double u = g2.energy(c);
+                    CHECK( g2.energy(c) == Approx(u) ); // repeated calls before sync agree
+                    GeneralizedBorn<Tspace> g3(jc, s2), g4(nocells, s2);
+                    CHECK( u == Approx(g3.energy(all)) );
+                    CHECK( u == Approx(g4.energy(all)) ); // all pairs
+                    if (step%2==0) { // accept
+                        s1.sync(s2, c);
+                        g1.sync(&g2, c);
+                    } else {         // reject
+                        s2.sync(s1, c);
+                        g2.sync(&g1, c);
+                    }
+                    CHECK( g1.energy(c) == Approx(g2.energy(c)) );
+                }
+                json out;
+                to_json(out, g2);
+                CHECK( out["generalizedborn"]["updated particles per move"].get<double>() < 10 ); // only neighbours
+                CHECK( out["generalizedborn"]["pair candidates per move"].get<double>() < 60 ); // from nearby cells; all pairs give at least 80
+                CHECK( out["generalizedborn"]["celllist"] == true );
+            }
+
+            atoms<Tspace::Tparticle> = backup;
+        }
+#endif
+
 #ifdef ENABLE_POWERSASA
         /*
          * @todo:
@@ -1193,11 +3108,12 @@ namespace Faunus {
 
                         ps->update_coords(spc.positions(), radii); // slowest step!
 
-                        for (size_t i=0; i<p.size(); i++) {
-                            auto &a = atoms<Tparticle>[p[i].id];
-                            if (std::fabs(a.tfe)>1e-9 || std::fabs(a.tension)>1e-9)
-                                ps->calc_sasa_single(i);
-                        }
+                        for (auto &g : spc.groups) // active particles only
+                            for (auto &i : g) {
+                                auto &a = atoms<Tparticle>[i.id];
+                                if (std::fabs(a.tfe)>1e-9 || std::fabs(a.tension)>1e-9)
+                                    ps->calc_sasa_single( &i - &p.front() );
+                            }
                         sasa = ps->getSasa();
                         assert(sasa.size()==p.size());
                     }
@@ -1262,11 +3178,13 @@ namespace Faunus {
                          * non-copyable.
                          */
                         updateSASA(spc.p); // ideally we want 
-                        for (size_t i=0; i<spc.p.size(); ++i) {
-                            auto &a = atoms<Tparticle>[ spc.p[i].id ];
-                            u += sasa[i] * (a.tension + conc * a.tfe);
-                            A += sasa[i];
-                        }
+                        for (auto &g : spc.groups) // active particles only
+                            for (auto &i : g) {
+                                size_t k = &i - &spc.p.front();
+                                auto &a = atoms<Tparticle>[i.id];
+                                u += sasa[k] * (a.tension + conc * a.tfe);
+                                A += sasa[k];
+                            }
                         avgArea+=A; // sample average area for accepted confs. only
                         return u;
                     }
@@ -1297,6 +3215,14 @@ namespace Faunus {
                             j.push_back(*i);
                     }
 
+                    double termEnergy(size_t i, Change &change) {
+                        auto &term = *this->vec[i];
+                        term.timer.start();
+                        double u = term.energy(change);
+                        term.timer.stop();
+                        return u;
+                    } //!< Timed energy of the i'th term
+
                     void addEwald(const json &j, Tspace &spc) {
                         if (j.count("coulomb")==1)
                             if (j["coulomb"].at("type")=="ewald")
@@ -1304,6 +3230,9 @@ namespace Faunus {
                     } //!< Adds an instance of reciprocal space Ewald energies (if appropriate)
 
                 public:
+                    bool tasks=false; //!< Evaluate independent terms as concurrent OpenMP tasks
+                    std::vector<double> latest; //!< Energy of each term from latest call to `energy()`
+
                     Hamiltonian(Tspace &spc, const json &j) {
                         using namespace Potential;
 
@@ -1344,9 +3273,15 @@ namespace Faunus {
                                     if (it.key()=="confine")
                                         push_back<Energy::Confine<Tspace>>(it.value(), spc);
 
+                                    if (it.key()=="externalgrid")
+                                        push_back<Energy::ExternalGrid<Tspace>>(it.value(), spc);
+
                                     if (it.key()=="example2d")
                                         push_back<Energy::Example2D>(it.value(), spc);
 
+                                    if (it.key()=="generalizedborn")
+                                        push_back<Energy::GeneralizedBorn<Tspace>>(it.value(), spc);
+
                                     if (it.key()=="isobaric")
                                         push_back<Energy::Isobaric<Tspace>>(it.value(), spc);
 
@@ -1376,9 +3311,46 @@ namespace Faunus {
 
                     double energy(Change &change) override {
                         double du=0;
-                        for (auto i : this->vec) {
-                            i->key=key;
-                            du += i->energy(change);
+                        latest.resize( this->vec.size() );
+                        if (tasks && this->vec.size()>1) {
+                            // exceptions may not escape a task; keep the first and rethrow afterwards
+                            std::exception_ptr error;
+#pragma omp parallel
+#pragma omp single
+                            {
+                                for (size_t i=0; i<this->vec.size(); i++) {
+                                    this->vec[i]->key=key;
+                                    if (this->vec[i]->concurrent) {
+#pragma omp task firstprivate(i) shared(change, error)
+                                        try {
+                                            latest[i] = termEnergy(i, change);
+                                        } catch (...) {
+#pragma omp critical (hamiltonian_error)
+                                            if (!error)
+                                                error = std::current_exception();
+                                        }
+                                    }
+                                }
+#pragma omp taskwait
+                                if (!error)
+                                    try {
+                                        for (size_t i=0; i<this->vec.size(); i++)
+                                            if (!this->vec[i]->concurrent)
+                                                latest[i] = termEnergy(i, change);
+                                    } catch (...) {
+                                        error = std::current_exception();
+                                    }
+                            }
+                            if (error)
+                                std::rethrow_exception(error);
+                            for (auto ui : latest) // sum in fixed order
+                                du += ui;
+                            return du;
+                        }
+                        for (size_t i=0; i<this->vec.size(); i++) {
+                            this->vec[i]->key=key;
+                            latest[i] = termEnergy(i, change);
+                            du += latest[i];
                         }
                         return du;
                     } //!< Energy due to changes
@@ -1388,6 +3360,18 @@ namespace Faunus {
                             i->init();
                     }
 
+                    void components(std::map<std::string,double> &u, std::map<double,double> &screened) override {
+                        for (auto i : this->vec)
+                            i->components(u, screened);
+                    } //!< Sum named energy parts of all terms
+
+                    size_t memory() const override {
+                        size_t n=0;
+                        for (auto i : this->vec)
+                            n += i->memory();
+                        return n;
+                    } //!< Memory of all terms (bytes)
+
                     void sync(Energybase* basePtr, Change &change) override {
                         auto other = dynamic_cast<decltype(this)>(basePtr);
                         if (other)
@@ -1401,5 +3385,49 @@ namespace Faunus {
 
             }; //!< Aggregates and sum energy terms
 
+#ifdef DOCTEST_LIBRARY_INCLUDED
+        TEST_CASE("[Faunus] Hamiltonian")
+        {
+            struct Constant : public Energybase {
+                double u;
+                Constant(double u, bool concurrent=true) : u(u) {
+                    name = "constant";
+                    this->concurrent = concurrent;
+                }
+                double energy(Change&) override {
+                    if (u<0)
+                        throw std::runtime_error("constant: negative");
+                    return u;
+                }
+            };
+
+            typedef Space<Geometry::Cuboid, Particle<Charge>> Tspace;
+            Tspace spc;
+            Hamiltonian<Tspace> pot(spc, R"( {"energy": []} )"_json);
+            pot.vec.push_back( std::make_shared<Constant>(1.0) );
+            pot.vec.push_back( std::make_shared<Constant>(2.0) );
+            pot.vec.push_back( std::make_shared<Constant>(4.0, false) );
+            Change change;
+            change.all = true;
+
+            for (bool tasks : {false, true}) {
+                pot.tasks = tasks;
+                CHECK( pot.energy(change) == doctest::Approx(7) );
+                CHECK( pot.latest.size()==3 );
+                CHECK( pot.latest[1] == doctest::Approx(2) );
+            }
+
+            SUBCASE("exception in concurrent term") {
+                pot.vec.push_back( std::make_shared<Constant>(-1.0) );
+                CHECK_THROWS_AS( pot.energy(change), std::runtime_error );
+            }
+
+            SUBCASE("exception in sequential term") {
+                pot.vec.push_back( std::make_shared<Constant>(-1.0, false) );
+                CHECK_THROWS_AS( pot.energy(change), std::runtime_error );
+            }
+        }
+#endif
+
     }//namespace
 }//namespace
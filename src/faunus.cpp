@@ -118,6 +118,13 @@ int main( int argc, char **argv )
         int macro = loop.at("macro");
         int micro = loop.at("micro");
 
+        json memory = sim.memory();
+        memory["analysis"] = analysis.memory();
+        if (!quiet)
+            mpi.cout() << "Estimated memory use (MB):\n" << std::setw(4) << memory << endl;
+
+        Telemetry telemetry( j.value("telemetry", json()) );
+
         ProgressBar progressBar(macro*micro, 70);
         for (int i=0; i<macro; i++) {
             for (int j=0; j<micro; j++) {
@@ -130,8 +137,10 @@ int main( int argc, char **argv )
 
                 sim.move();
                 analysis.sample();
+                telemetry.update(sim, analysis, (unsigned long long)i*micro+j+1, (unsigned long long)macro*micro);
             }
         }
+        telemetry.update(sim, analysis, (unsigned long long)macro*micro, (unsigned long long)macro*micro, true);
         if (showProgress && mpi.isMaster())
             progressBar.done();
 
@@ -144,6 +153,8 @@ int main( int argc, char **argv )
             json j = sim;
             j["relative drift"] = sim.drift();
             j["analysis"] = analysis;
+            j["memory (MB)"] = sim.memory();
+            j["memory (MB)"]["analysis"] = analysis.memory();
             if (mpi.nproc()>1)
                 j["mpi"] = mpi;
 #ifdef GIT_COMMIT_HASH
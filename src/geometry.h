@@ -186,6 +186,10 @@ namespace Faunus {
                     a = vdist(a, ref) + ref;
                 } //!< Remove PBC with respect to a reference point
 
+                Eigen::Vector3i periodicity() const {
+                    return Eigen::Vector3i(X,Y,Z);
+                } //!< Periodic directions (1=periodic, 0=not)
+
                 template<typename T=double>
                     inline int anint( T x ) const
                     {
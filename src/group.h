@@ -153,6 +153,38 @@ namespace Faunus {
             int id=-1;
             bool atomic=false;   //!< Is it an atomic group?
             Point cm={0,0,0};    //!< Mass center
+            double mass=0;       //!< Total mass of active particles (zero = not yet calculated)
+            size_t nmass=0;      //!< Number of active particles summed in `mass`
+            Eigen::Quaterniond orientation=Eigen::Quaterniond::Identity(); //!< Accumulated rotation, see `rotate()`
+
+            struct Moments {
+                Point ref={0,0,0};  //!< Reference point from which positions are measured
+                Point mr={0,0,0};   //!< Sum of m(r-ref)
+                Point qr={0,0,0};   //!< Sum of q(r-ref)
+                Eigen::Matrix3d mrr=Eigen::Matrix3d::Zero(); //!< Sum of m(r-ref)(r-ref)^T
+                Eigen::Matrix3d qrr=Eigen::Matrix3d::Zero(); //!< Sum of q(r-ref)(r-ref)^T
+                double m=0, q=0;    //!< Total mass and charge of active particles
+                bool valid=false;   //!< False until calculated by `updateMoments()`
+
+                double charge() const { return q; } //!< Net charge
+
+                Point dipole() const {
+                    return (m>0) ? Point(qr - q/m*mr) : qr;
+                } //!< Dipole moment about the mass center
+
+                Eigen::Matrix3d gyration() const {
+                    if (m<=0)
+                        return Eigen::Matrix3d::Zero();
+                    Point c = mr / m;
+                    return mrr / m - c*c.transpose();
+                } //!< Mass weighted gyration tensor about the mass center
+
+                Eigen::Matrix3d quadrupole() const {
+                    Point c = (m>0) ? Point(mr / m) : Point(0,0,0);
+                    Eigen::Matrix3d t = qr*c.transpose();
+                    return 0.5 * (qrr - t - t.transpose() + q*c*c.transpose());
+                } //!< Quadrupole moment tensor (with trace) about the mass center
+            } moments; //!< Sums over active particles, maintained by `translate()`, `rotate()` and `Space::updateMoments()`
 
             template<class Trange>
                 Group(Trange &rng) : base(rng.begin(), rng.end()) {
@@ -180,6 +212,10 @@ namespace Faunus {
                     id = o.id;
                     atomic = o.atomic;
                     cm = o.cm;
+                    mass = o.mass;
+                    nmass = o.nmass;
+                    orientation = o.orientation;
+                    moments = o.moments;
                 }
                 return *this;
             } //!< copy group data from `other` but *not* particle data
@@ -226,15 +262,86 @@ namespace Faunus {
             void translate(const Point &d, Geometry::BoundaryFunction boundary=[](Point&){}) {
                 cm += d;
                 boundary(cm);
+                moments.ref += d; // positions relative to the reference are unchanged
+                boundary(moments.ref);
                 for (auto &i : *this) {
                     i.pos += d;
                     boundary(i.pos);
                 }
-            } //!< Translate particle positions and mass center
+            } //!< Translate particle positions, mass center and `moments`
+
+            void updateMass() {
+                mass=0;
+                for (auto &i : *this)
+                    mass += atoms<T>.at(i.id).mw;
+                nmass = this->size();
+            } //!< Recalculate mass of active particles from atom weights (Order N complexity)
+
+            void displaceMassCenter(const T &a, const Point &d, Geometry::BoundaryFunction boundary=[](Point&){}) {
+                if (mass<=0 || nmass!=this->size())
+                    updateMass();
+                if (mass>0) {
+                    cm += atoms<T>.at(a.id).mw / mass * d;
+                    boundary(cm);
+                }
+            } //!< Update mass center after displacing particle `a` by `d` (Order 1 complexity)
+
+            template<typename TdistanceFunc>
+                static void addMoments(Moments &s, const T &a, const TdistanceFunc &vdist, double sign=1) {
+                    double m = sign * atoms<T>.at(a.id).mw, q = sign * a.charge;
+                    Point r = vdist(a.pos, s.ref);
+                    s.m += m;
+                    s.q += q;
+                    s.mr += m*r;
+                    s.qr += q*r;
+                    s.mrr += m*r*r.transpose();
+                    s.qrr += q*r*r.transpose();
+                } //!< Add (sign=1) or remove (sign=-1) the contribution of particle `a` to `s`
+
+            template<typename TdistanceFunc>
+                void addMoments(const T &a, const TdistanceFunc &vdist, double sign=1) {
+                    addMoments(moments, a, vdist, sign);
+                } //!< Add (sign=1) or remove (sign=-1) the contribution of particle `a` to `moments`
+
+            template<typename TdistanceFunc>
+                Moments calcMoments(const TdistanceFunc &vdist) const {
+                    Moments s;
+                    s.ref = cm;
+                    for (auto &i : *this)
+                        addMoments(s, i, vdist);
+                    s.valid = true;
+                    return s;
+                } //!< Moments calculated from scratch relative to the mass center (Order N complexity)
+
+            template<typename TdistanceFunc>
+                Moments currentMoments(const TdistanceFunc &vdist) const {
+                    return moments.valid ? moments : calcMoments(vdist);
+                } //!< `moments` if maintained, otherwise calculated from scratch
+
+            template<typename TdistanceFunc>
+                void updateMoments(const TdistanceFunc &vdist) {
+                    moments = calcMoments(vdist);
+                } //!< Recalculate `moments` relative to the mass center (Order N complexity)
+
+            double charge() const { return moments.charge(); } //!< Net charge from `moments`
+            Point dipole() const { return moments.dipole(); } //!< Dipole moment about the mass center from `moments`
+            Eigen::Matrix3d gyration() const { return moments.gyration(); } //!< Mass weighted gyration tensor about the mass center from `moments`
 
             void rotate(const Eigen::Quaterniond &Q, Geometry::BoundaryFunction boundary) {
                 Geometry::rotate(begin(), end(), Q, boundary, -cm);
-            } //!< Rotate all particles in group incl. internal coordinates (dipole moment etc.)
+                orientation = Q * orientation;
+
+                // r-ref becomes Q(r-ref) when the reference is rotated along with the particles
+                Eigen::Matrix3d R = Q.toRotationMatrix();
+                Point ref = moments.ref - cm;
+                boundary(ref);
+                moments.ref = Q * ref + cm;
+                boundary(moments.ref);
+                moments.mr = R * moments.mr;
+                moments.qr = R * moments.qr;
+                moments.mrr = R * moments.mrr * R.transpose();
+                moments.qrr = R * moments.qrr * R.transpose();
+            } //!< Rotate all particles in group incl. internal coordinates (dipole moment etc.) and `moments`
 
         }; //!< Groups of particles
 
@@ -302,6 +409,53 @@ namespace Faunus {
         CHECK( p[1].pos.y() == doctest::Approx(10) );
         CHECK( p[1].pos.z() == doctest::Approx(12) );
 
+        SUBCASE("incremental mass center") {
+            auto backup = atoms<particle>;
+            atoms<particle>.resize(2);
+            atoms<particle>[0].mw = 1;
+            atoms<particle>[1].mw = 3;
+            g.cm = Geometry::massCenter(g.begin(), g.end());
+            Point d = {0.5, -1, 2};
+            p[1].pos += d;
+            g.displaceMassCenter(p[1], d);
+            CHECK( g.mass == doctest::Approx(7) );
+            CHECK( (g.cm - Geometry::massCenter(g.begin(), g.end())).norm() == doctest::Approx(0) );
+
+            g.resize(2); // only active particles contribute
+            g.cm = Geometry::massCenter(g.begin(), g.end());
+            p[0].pos += d;
+            g.displaceMassCenter(p[0], d);
+            CHECK( g.mass == doctest::Approx(4) );
+            CHECK( (g.cm - Geometry::massCenter(g.begin(), g.end())).norm() == doctest::Approx(0) );
+            atoms<particle> = backup;
+        }
+
+        SUBCASE("rigid body moments") {
+            auto backup = atoms<particle>;
+            atoms<particle>.resize(2);
+            atoms<particle>[0].mw = 1;
+            atoms<particle>[1].mw = 3;
+            Geometry::Cuboid box = R"({"length": [10,10,10]})"_json;
+            auto vdist = [&](const Point &a, const Point &b) { return box.vdist(a,b); };
+            p[0].pos = {4.5, 0, 0};
+            p[1].pos = {-4.5, 1, 0}; // across the boundary
+            p[2].pos = {4, -1, 1};
+            p[0].charge = 1;
+            p[1].charge = -0.5;
+            p[2].charge = 2;
+            g.cm = Geometry::massCenter(g.begin(), g.end(), box.boundaryFunc, -p[0].pos);
+            g.updateMoments(vdist);
+            g.translate({3, -2, 1}, box.boundaryFunc);
+            g.rotate( Eigen::Quaterniond(Eigen::AngleAxisd(0.8, Point(1,2,-1).normalized())), box.boundaryFunc );
+            auto s = g.calcMoments(vdist);
+            CHECK( g.charge() == doctest::Approx(s.charge()) );
+            CHECK( (g.dipole() - s.dipole()).norm() == doctest::Approx(0) );
+            CHECK( (g.gyration() - s.gyration()).norm() == doctest::Approx(0) );
+            CHECK( (g.moments.quadrupole() - s.quadrupole()).norm() == doctest::Approx(0) );
+            CHECK( g.dipole().norm() > 1 );
+            atoms<particle> = backup;
+        }
+
 #pragma OPTIMIZE OFF
         SUBCASE("test find_index") {
             CHECK( p.begin() == g.begin() );
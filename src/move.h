@@ -6,6 +6,16 @@
 //#include "analysis.h"
 #include "potentials.h"
 #include "mpi.h"
+#include <cstdio>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 namespace Faunus {
     namespace Move {
@@ -54,6 +64,9 @@ namespace Faunus {
                     _roundjson(j, 3);
                 } //!< JSON report w. statistics, output etc.
 
+                double relativeTime() const { return timer.result(); } //!< Fraction of run time spent in move
+                double acceptance() const { return cnt>0 ? double(accepted)/cnt : 0; } //!< Fraction of accepted moves
+
                 inline void move(Change &change) {
                     timer.start();
                     cnt++;
@@ -184,6 +197,7 @@ namespace Faunus {
                         repeat = -1; // meaning repeat N times
                         cdata.atoms.resize(1);
                         cdata.internal=true;
+                        cdata.property=Change::CHARGE;
                     }
             };
 
@@ -266,7 +280,7 @@ namespace Faunus {
                                 spc.geo.boundaryFunc(p->pos);
                                 _sqd = spc.geo.sqdist(oldpos, p->pos); // squared displacement
                                 if (!g.atomic)
-                                    g.cm = Geometry::massCenter(g.begin(), g.end(), spc.geo.boundaryFunc, -g.cm);
+                                    g.displaceMassCenter(*p, spc.geo.vdist(p->pos, oldpos), spc.geo.boundaryFunc);
                             }
 
                             if (dprot>0) { // rotate
@@ -732,13 +746,16 @@ namespace Faunus {
                             n = cluster.size();
                             for (size_t i : cluster)
                                 if (!spc.groups[i].empty()) // check if group is inactive
-                                    for (size_t j : pool)
-                                        if (!spc.groups[j].empty()) // check if group is inactive
-                                            if (i!=j)
-                                                if (spc.geo.sqdist(spc.groups[i].cm, spc.groups[j].cm)<=thresholdsq) {
-                                                    cluster.insert(j);
-                                                    pool.erase(j);
+                                    for (auto j=pool.begin(); j!=pool.end(); ) {
+                                        if (!spc.groups[*j].empty()) // check if group is inactive
+                                            if (i!=*j)
+                                                if (spc.geo.sqdist(spc.groups[i].cm, spc.groups[*j].cm)<=thresholdsq) {
+                                                    cluster.insert(*j);
+                                                    j = pool.erase(j); // erase invalidates `j`
+                                                    continue;
                                                 }
+                                        ++j;
+                                    }
                         } while (cluster.size()!=n);
 
                         // check if cluster is too large
@@ -769,13 +786,11 @@ namespace Faunus {
                             for (auto i : cluster) { // loop over molecules in cluster
                                 auto &g = spc.groups[i];
 
-                                Geometry::rotate(g.begin(), g.end(), Q, spc.geo.boundaryFunc, -COM);
-                                g.cm = g.cm-COM;
-                                spc.geo.boundary(g.cm);
-                                g.cm = Q*g.cm+COM;
-                                spc.geo.boundary(g.cm);
-
-                                g.translate( dp, spc.geo.boundaryFunc );
+                                // rotation around COM = rotation around cm followed by a displacement of cm
+                                Point r = g.cm-COM;
+                                spc.geo.boundary(r);
+                                g.rotate( Q, spc.geo.boundaryFunc );
+                                g.translate( Q*r - r + dp, spc.geo.boundaryFunc );
                                 d.index=i;
                                 change.groups.push_back(d);
                             }
@@ -877,11 +892,12 @@ namespace Faunus {
                                             Eigen::Quaterniond Q( Eigen::AngleAxisd(angle, u) );
                                             auto M = Q.toRotationMatrix();
                                             for (auto i : index) {
+                                                Point oldpos = spc.p[i].pos;
                                                 spc.p[i].rotate(Q, M); // internal rot.
                                                 spc.p[i].pos = Q * ( spc.p[i].pos - spc.p[i1].pos)
                                                     + spc.p[i1].pos; // positional rot.
+                                                g->displaceMassCenter(spc.p[i], spc.p[i].pos - oldpos); // only rotated atoms contribute
                                             }
-                                            g->cm = Geometry::massCenter(g->begin(), g->end());
                                             g->wrap(spc.geo.boundaryFunc); // re-apply pbc
 
                                             d2 = spc.geo.sqdist(g->cm, oldcm); // CM movement
@@ -1100,6 +1116,91 @@ namespace Faunus {
 
     }//Move namespace
 
+    /**
+     * @brief Thread control for OpenMP parallel energy evaluation
+     *
+     * The OpenMP runtime keeps its thread team alive between parallel
+     * regions so no extra pool is needed; this sets the team size,
+     * nesting and the scheduling of the group-to-group loops. Threads
+     * may be pinned to the CPUs available to the process (`bind`, Linux
+     * only) and particle memory may be moved to the NUMA nodes of the
+     * threads that later use it (`firsttouch`, Linux only) so that it is
+     * placed close to them. Pinning through `OMP_PROC_BIND` and `OMP_PLACES`
+     * is still honoured and reported in the output.
+     */
+    struct OpenMPControl {
+        int threads=0;       //!< Number of threads (0=runtime default)
+        int chunk=1;         //!< Chunk size for dynamic scheduling of group loops
+        bool sections=true;  //!< Evaluate old and new energies concurrently
+        bool nested=false;   //!< Allow group loops to spawn threads inside sections
+        bool tasks=false;    //!< Evaluate independent energy terms as concurrent tasks
+        bool firsttouch=false; //!< Move the memory of each group to the NUMA node of the thread handling it
+        std::string bind="none"; //!< Pin threads to CPUs: "none", "close" or "spread"
+
+        void apply() const {
+#ifdef _OPENMP
+            if (threads>0)
+                omp_set_num_threads(threads);
+            // sections, tasks and group loops each open a parallel region inside the previous one
+            int levels = 1;
+            if (sections && (tasks || nested))
+                levels++;
+            if (tasks && nested)
+                levels++;
+            omp_set_max_active_levels(levels);
+            omp_set_schedule( omp_sched_dynamic, chunk );
+#ifdef __linux__
+            if (bind!="none") {
+                cpu_set_t mask;
+                if (sched_getaffinity(0, sizeof(mask), &mask)==0) {
+                    std::vector<int> cpus; // CPUs available to the process
+                    for (int i=0; i<CPU_SETSIZE; i++)
+                        if (CPU_ISSET(i, &mask))
+                            cpus.push_back(i);
+#pragma omp parallel
+                    {
+                        int t = omp_get_thread_num(), n = omp_get_num_threads();
+                        int cpu = (bind=="spread") ? cpus[ (t*cpus.size()) / n ] : cpus[ t % cpus.size() ];
+                        cpu_set_t own;
+                        CPU_ZERO(&own);
+                        CPU_SET(cpu, &own);
+                        sched_setaffinity(0, sizeof(own), &own); // 0 = calling thread
+                    }
+                }
+            }
+#endif
+#endif
+        } //!< Apply settings to OpenMP runtime
+    };
+
+    void from_json(const json &j, OpenMPControl &o) {
+        o.threads = j.value("threads", o.threads);
+        o.chunk = j.value("chunk", o.chunk);
+        o.sections = j.value("sections", o.sections);
+        o.nested = j.value("nested", o.nested);
+        o.tasks = j.value("tasks", o.tasks);
+        o.firsttouch = j.value("firsttouch", o.firsttouch);
+        o.bind = j.value("bind", o.bind);
+        if (o.threads<0 || o.chunk<1)
+            throw std::runtime_error("openmp: 'threads' must be non-negative and 'chunk' positive");
+        if (o.bind!="none" && o.bind!="close" && o.bind!="spread")
+            throw std::runtime_error("openmp: 'bind' must be 'none', 'close' or 'spread'");
+    }
+
+    void to_json(json &j, const OpenMPControl &o) {
+        j = { {"chunk", o.chunk}, {"sections", o.sections}, {"nested", o.nested}, {"tasks", o.tasks},
+            {"firsttouch", o.firsttouch}, {"bind", o.bind} };
+#ifdef _OPENMP
+        j["threads"] = omp_get_max_threads();
+        const std::vector<std::string> bind = {"false", "true", "master", "close", "spread"};
+        int b = omp_get_proc_bind();
+        if (b>=0 && b<int(bind.size()))
+            j["binding"] = bind[b];
+#else
+        j["threads"] = 1;
+#endif
+    }
+
     template<class Tgeometry, class Tparticle>
         class MCSimulation {
             private:
@@ -1117,7 +1218,13 @@ namespace Faunus {
                 struct State {
                     Tspace spc;
                     Energy::Hamiltonian<Tspace> pot;
-                    State(const json &j) : spc(j), pot(spc,j) {}
+                    State(const json &j, const OpenMPControl &openmp) : spc(j), pot(place(spc, openmp), j) {}
+
+                    static Tspace& place(Tspace &spc, const OpenMPControl &openmp) {
+                        if (openmp.firsttouch)
+                            spc.placeMemory();
+                        return spc;
+                    } //!< Place particle memory before energy terms are built on it
 
                     void sync(State &other, Change &change) {
                         spc.sync( other.spc, change );
@@ -1125,11 +1232,93 @@ namespace Faunus {
                     }
                 }; //!< Contains everything to describe a state
 
+                OpenMPControl openmp;   //!< Thread control; applied before the states are built
+
                 State state1, // old state
                       state2; // new state (trial);
-                double uinit=0, dusum=0;
+                double uinit=0;
+                KahanSum<double> dusum; //!< Sum of all energy changes (compensated)
                 Average<double> uavg;
 
+                int validate=0;                 //!< Validate energies and states every n'th move (0=never)
+                double validatetol=1e-6;        //!< Relative tolerance for energy validation
+                unsigned long long int validatecnt=0, validations=0;
+                std::vector<double> uterm;      //!< Energy of each term at latest validation
+                std::vector<KahanSum<double>> dusumterm; //!< Energy change of each term since latest validation
+                std::set<std::string> validatemoves; //!< Moves performed since latest validation
+
+                void validateState() {
+                    Change c; c.all=true;
+                    std::ostringstream o;
+                    bool fail=false;
+
+                    // after sync, old and new states must be identical
+                    if ( json(state1.spc.p) != json(state2.spc.p) ) {
+                        o << "particles in old and new states differ\n";
+                        fail=true;
+                    }
+                    for (size_t i=0; i<state1.spc.groups.size(); i++) {
+                        auto &g1 = state1.spc.groups[i];
+                        auto &g2 = state2.spc.groups[i];
+                        if ( g1.size()!=g2.size() || g1.capacity()!=g2.capacity() || g1.cm!=g2.cm ) {
+                            o << "group " << i << " in old and new states differ\n";
+                            fail=true;
+                        }
+                    }
+
+                    // incrementally updated mass centers and moments must match a recomputation
+                    for (size_t i=0; i<state1.spc.groups.size() && !fail; i++) {
+                        auto &g = state1.spc.groups[i];
+                        if (g.atomic || g.empty())
+                            continue;
+                        auto &geo = state1.spc.geo;
+                        Point cm = Geometry::massCenter(g.begin(), g.end(), geo.boundaryFunc, -g.cm);
+                        double dev = std::sqrt( geo.sqdist(cm, g.cm) );
+                        if (dev > validatetol * std::max(1.0, cm.norm())) {
+                            o << "group " << i << " mass center deviates by " << dev << " from recomputed value\n";
+                            fail=true;
+                        }
+                        auto s = g.calcMoments( [&](const Point &a, const Point &b) { return geo.vdist(a,b); } );
+                        double q = s.charge();
+                        Point mu = s.dipole();
+                        Eigen::Matrix3d S = s.gyration();
+                        if ( !g.moments.valid || std::fabs(q-g.charge()) > validatetol * std::max(1.0, std::fabs(q))
+                                || (mu-g.dipole()).norm() > validatetol * std::max(1.0, mu.norm())
+                                || (S-g.gyration()).norm() > validatetol * std::max(1.0, S.norm()) ) {
+                            o << "group " << i << " charge, dipole or gyration deviates from recomputed value\n";
+                            fail=true;
+                        }
+                    }
+
+                    // compare each term: cached/incremental (old), from scratch (new), and tracked sum
+                    state1.pot.energy(c);
+                    state2.pot.energy(c);
+                    auto &uold = state1.pot.latest;
+                    auto &unew = state2.pot.latest;
+                    for (size_t i=0; i<unew.size(); i++) {
+                        double utrack = uterm[i] + dusumterm[i];
+                        double tol = validatetol * std::max(1.0, std::fabs(unew[i]));
+                        if ( std::fabs(unew[i]-uold[i]) > tol || std::fabs(unew[i]-utrack) > tol ) {
+                            o << "energy term '" << state1.pot.vec[i]->name << "': scratch=" << unew[i]
+                                << " cached=" << uold[i] << " tracked=" << utrack << "\n";
+                            fail=true;
+                        }
+                    }
+
+                    if (fail) {
+                        std::string moves;
+                        for (auto &m : validatemoves)
+                            moves += " " + m;
+                        throw std::runtime_error("validation failed after " + std::to_string(validatecnt)
+                                + " moves using moves:" + moves + "\n" + o.str());
+                    }
+
+                    uterm = unew;
+                    dusumterm.assign( uterm.size(), KahanSum<double>() );
+                    validatemoves.clear();
+                    validations++;
+                } //!< Compare energy terms with from-scratch values and check that states are in sync
+
                 void init() {
                     state1.pot.key = Energy::Energybase::OLD; // this is the old energy (current)
                     state2.pot.key = Energy::Energybase::NEW; // this is the new energy (trial)
@@ -1137,8 +1326,11 @@ namespace Faunus {
                     state2.pot.init();
                     dusum=0;
                     Change c; c.all=true;
+                    state1.spc.updateMoments();
                     state2.sync(state1, c);
                     uinit = state1.pot.energy(c);
+                    uterm = state1.pot.latest;
+                    dusumterm.assign( uterm.size(), KahanSum<double>() );
 
                     // Hack in reference to state1 in speciation
                     for (auto base : moves.vec) {
@@ -1159,13 +1351,68 @@ namespace Faunus {
                 const auto& geometry() const { return state1.spc.geo; }
                 const auto& particles() const { return state1.spc.p; }
 
+                std::vector<std::pair<std::string,double>> energyTimes() const {
+                    std::vector<std::pair<std::string,double>> v;
+                    for (size_t i=0; i<state1.pot.vec.size(); i++)
+                        v.push_back( {state1.pot.vec[i]->name,
+                                state1.pot.vec[i]->timer.result() + state2.pot.vec[i]->timer.result()} );
+                    return v;
+                } //!< Fraction of run time spent in each energy term (old and new states)
+
+                json memory() const {
+                    size_t conformations=0;
+                    for (auto &m : molecules<Tpvec>) {
+                        conformations += memsize(m.conformations);
+                        for (auto &c : m.conformations)
+                            conformations += memsize(c);
+                    }
+                    std::map<std::string, size_t> terms;
+                    for (size_t i=0; i<state1.pot.vec.size(); i++)
+                        terms[ state1.pot.vec[i]->name ] += state1.pot.vec[i]->memory() + state2.pot.vec[i]->memory();
+                    json j = {
+                        {"space", _round( (state1.spc.memory() + state2.spc.memory())/1e6 )},
+                        {"conformations", _round( conformations/1e6 )}
+                    };
+                    auto &_j = j["energy"] = json::object();
+                    for (auto &i : terms)
+                        if (i.second>0)
+                            _j[i.first] = _round( i.second/1e6 );
+                    return j;
+                } //!< Estimated memory use (MB) of both states, conformation libraries and energy terms
+
                 double drift() {
                     Change c; c.all=true;
                     double ufinal = state1.pot.energy(c);
                     return ( ufinal-(uinit+dusum) ) / uinit;
                 } //!< Calculates the relative energy drift from initial configuration
 
-                MCSimulation(const json &j, MPI::MPIController &mpi) : state1(j), state2(j), moves(j, state2.spc, mpi) {
+                static OpenMPControl applyOpenMP(const json &j) {
+                    OpenMPControl o = j.value("openmp", json::object());
+                    o.apply();
+                    return o;
+                } //!< Thread settings from input, applied at once so that threads are pinned before memory is placed
+
+                MCSimulation(const json &j, MPI::MPIController &mpi) : openmp(applyOpenMP(j)),
+                    state1(j, openmp), state2(j, openmp), moves(j, state2.spc, mpi) {
+                    state1.pot.tasks = state2.pot.tasks = openmp.tasks;
+                    bool mpisplit=false;
+                    for (auto &term : j.at("energy"))
+                        for (auto it=term.begin(); it!=term.end(); ++it)
+                            if (it->count("coulomb") && it->at("coulomb").value("mpisplit", false))
+                                mpisplit=true;
+                    if (mpisplit) {
+#ifdef _OPENMP
+                        if (openmp.sections || openmp.tasks) // MPI reductions must be made from the main thread
+                            throw std::runtime_error("ewald: mpisplit requires openmp sections=false and tasks=false");
+#endif
+                        for (auto &m : j.at("moves")) // ranks share one system and cannot exchange replicas
+                            if (m.count("temper"))
+                                throw std::runtime_error("ewald: mpisplit cannot be combined with temper");
+                    }
+                    if (j.count("validate")) {
+                        validate = j["validate"].value("interval", 0);
+                        validatetol = j["validate"].value("tolerance", validatetol);
+                    }
                     init();
                 }
 
@@ -1193,8 +1440,9 @@ namespace Faunus {
                             (**mv).move(change);
 
                             if (!change.empty()) {
+                                state2.spc.updateMoments(state1.spc, change);
                                 double unew, uold, du;
-#pragma omp parallel sections
+#pragma omp parallel sections if (openmp.sections)
                                 {
 #pragma omp section
                                     { unew = state2.pot.energy(change); }
@@ -1205,6 +1453,8 @@ namespace Faunus {
                                 double bias = (**mv).bias(change, uold, unew) + Nchem( state2.spc, state1.spc , change);
 
                                 if ( metropolis(du + bias) ) { // accept move
+                                    for (size_t k=0; k<dusumterm.size(); k++)
+                                        dusumterm[k] += state2.pot.latest[k] - state1.pot.latest[k];
                                     state1.sync( state2, change );
                                     (**mv).accept(change);
                                 }
@@ -1214,6 +1464,12 @@ namespace Faunus {
                                     du=0;
                                 }
                                 dusum+=du; // sum of all energy changes
+
+                                if (validate>0) {
+                                    validatemoves.insert( (**mv).name );
+                                    if (++validatecnt % validate == 0)
+                                        validateState();
+                                }
                             }
                         }
                     }
@@ -1224,6 +1480,9 @@ namespace Faunus {
                     j["temperature"] = pc::temperature / 1.0_K;
                     j["moves"] = moves;
                     j["energy"].push_back(state1.pot);
+                    j["openmp"] = openmp;
+                    if (validate>0)
+                        j["validate"] = { {"interval", validate}, {"tolerance", validatetol}, {"validations", validations} };
                 }
         };
 
@@ -1232,6 +1491,246 @@ namespace Faunus {
             mc.to_json(j);
         }
 
+#ifdef DOCTEST_LIBRARY_INCLUDED
+    TEST_CASE("[Faunus] MCSimulation")
+    {
+        typedef Particle<Charge> Tparticle;
+        typedef std::vector<Tparticle> Tpvec;
+        auto atombackup = atoms<Tparticle>;
+        auto molbackup = molecules<Tpvec>;
+        json j = R"( {
+            "energy": [ {"nonbonded_coulomblj": {
+                "lennardjones": {"mixing": "LB"}, "coulomb": {"type": "plain", "epsr": 80, "cutoff": 20} } } ],
+            "atomlist": [ {"Na": {"q": 1.0, "eps": 0.15, "sigma": 4.0, "dp": 5}},
+                          {"Cl": {"q": -1.0, "eps": 0.2, "sigma": 4.0, "dp": 5}},
+                          {"M": {"q": 0.5, "eps": 0.2, "sigma": 4.0, "dp": 0.5, "mw": 10}},
+                          {"N": {"q": -0.5, "eps": 0.2, "sigma": 4.0, "dp": 0.5, "mw": 30}} ],
+            "moleculelist": [ {"salt": {"atoms": ["Na", "Cl"], "atomic": true}},
+                              {"chain": {"structure": [ {"M": [0,0,0]}, {"N": [4.5,0,0]}, {"M": [9,0,0]} ]}} ],
+            "insertmolecules": [ {"salt": {"N": 10}}, {"chain": {"N": 2}} ],
+            "moves": [ {"transrot": {"molecule": "salt", "dp": 5, "dprot": 0}},
+                       {"transrot": {"molecule": "chain", "dprot": 0}},
+                       {"moltransrot": {"molecule": "chain", "dp": 2, "dprot": 1}} ],
+            "geometry": {"length": 30}, "temperature": 300 } )"_json;
+        MPI::MPIController mpi;
+
+        SUBCASE("incremental mass centers and moments") {
+            j["moves"].push_back( R"( {"cluster": {"molecules": ["chain"], "threshold": 12, "dp": 2, "dprot": 1}} )"_json );
+            j["validate"] = { {"interval", 10} };
+            MCSimulation<Geometry::Cuboid, Tparticle> sim(j, mpi);
+            for (int i=0; i<200; i++)
+                sim.move();
+            auto &geo = sim.space().geo;
+            for (auto &g : sim.space().groups)
+                if (!g.atomic) {
+                    Point cm = Geometry::massCenter(g.begin(), g.end(), geo.boundaryFunc, -g.cm);
+                    CHECK( geo.sqdist(cm, g.cm) == doctest::Approx(0) );
+                    double q=0, m=0;
+                    Point mu(0,0,0);
+                    Eigen::Matrix3d S = Eigen::Matrix3d::Zero();
+                    for (auto &a : g) {
+                        Point r = geo.vdist(a.pos, cm);
+                        double mw = atoms<Tparticle>.at(a.id).mw;
+                        q += a.charge;
+                        m += mw;
+                        mu += a.charge * r;
+                        S += mw * r * r.transpose();
+                    }
+                    CHECK( g.moments.valid );
+                    CHECK( g.charge() == doctest::Approx(q) );
+                    CHECK( (g.dipole()-mu).norm() == doctest::Approx(0) );
+                    CHECK( (g.gyration()-S/m).norm() == doctest::Approx(0) );
+                }
+        }
+
+        SUBCASE("memory placement") {
+            j["openmp"] = { {"firsttouch", true} };
+            j["validate"] = { {"interval", 5} };
+            MCSimulation<Geometry::Cuboid, Tparticle> sim(j, mpi);
+            auto p = sim.space().p.data();
+            for (int i=0; i<50; i++)
+                CHECK_NOTHROW( sim.move() );
+            CHECK( sim.space().p.data()==p ); // placement must not reallocate particles
+        }
+
+#ifdef ENABLE_MPI
+        SUBCASE("mpisplit excludes temper") {
+            json in = j;
+            in["energy"][0]["nonbonded_coulomblj"]["coulomb"] = R"( {"type": "ewald", "epsr": 80, "cutoff": 10,
+                "alpha": 0.3, "kcutoff": 4, "mpisplit": true} )"_json;
+            in["openmp"] = { {"sections", false} };
+            in["moves"].push_back( R"( {"temper": {"format": "XYZQI"}} )"_json );
+            CHECK_THROWS_AS( (MCSimulation<Geometry::Cuboid, Tparticle>(in, mpi)), std::runtime_error );
+        }
+#endif
+
+        j["validate"] = { {"interval", 1} };
+        MCSimulation<Geometry::Cuboid, Tparticle> sim(j, mpi);
+
+        SUBCASE("consistent states pass validation") {
+            for (int i=0; i<20; i++)
+                CHECK_NOTHROW( sim.move() );
+            json out;
+            sim.to_json(out);
+            CHECK( out["validate"]["validations"].get<int>() > 0 );
+        }
+
+        SUBCASE("out of sync states fail validation") {
+            for (auto &i : sim.space().p) // a move copies only one particle back
+                i.charge *= 2;
+            CHECK_THROWS( sim.move() );
+        }
+        atoms<Tparticle> = atombackup;
+        molecules<Tpvec> = molbackup;
+    }
+#endif
+
+    /**
+     * @brief Periodic performance telemetry in Prometheus text format
+     *
+     * At most every `interval` seconds, run-time metrics are written to `file`
+     * which is replaced atomically so that it can be scraped while the
+     * simulation is running, e.g. by the node exporter textfile collector.
+     */
+    class Telemetry {
+        private:
+            typedef std::chrono::steady_clock Tclock;
+            std::string file;                 //!< Output file (empty = disabled)
+            double interval=60;               //!< Minimum time between updates (seconds)
+            Tclock::time_point t0, tlast;
+            unsigned long long steplast=0;
+
+            static std::string label(const std::string &key, std::string value) {
+                std::string s;
+                for (char c : value) {
+                    if (c=='"' || c=='\\')
+                        s += '\\';
+                    s += c;
+                }
+                return "{" + key + "=\"" + s + "\"}";
+            } //!< Prometheus label with escaped value
+
+            static void header(std::ostream &o, const std::string &name, const std::string &help, const std::string &type="gauge") {
+                o << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+            }
+
+            static double residentMemory() {
+                std::ifstream f("/proc/self/statm");
+                double pages, rss;
+                if (f >> pages >> rss)
+                    return rss * sysconf(_SC_PAGESIZE);
+                return 0;
+            } //!< Resident memory in bytes (zero if unavailable)
+
+        public:
+            Telemetry(const json &j=json()) {
+                if (j.is_object()) {
+                    file = MPI::prefix + j.value("file", std::string("telemetry.prom"));
+                    interval = j.value("interval", interval);
+                }
+                t0 = tlast = Tclock::now();
+            } //!< Keywords: `file`, `interval`
+
+            template<class Tsimulation, class Tanalysis>
+                void update(const Tsimulation &sim, const Tanalysis &analysis,
+                        unsigned long long step, unsigned long long nsteps, bool force=false) {
+                    if (file.empty())
+                        return;
+                    auto now = Tclock::now();
+                    double dt = std::chrono::duration<double>(now - tlast).count();
+                    if (dt < interval && !force)
+                        return;
+                    double elapsed = std::chrono::duration<double>(now - t0).count();
+
+                    std::ostringstream o;
+                    header(o, "faunus_steps", "Monte Carlo steps performed", "counter");
+                    o << "faunus_steps " << step << "\n";
+                    header(o, "faunus_steps_per_second", "Monte Carlo steps per second since last update");
+                    o << "faunus_steps_per_second " << (dt>0 ? (step-steplast)/dt : 0) << "\n";
+                    header(o, "faunus_progress_ratio", "Fraction of all steps completed");
+                    o << "faunus_progress_ratio " << (nsteps>0 ? double(step)/nsteps : 0) << "\n";
+                    header(o, "faunus_remaining_seconds", "Projected time to completion");
+                    o << "faunus_remaining_seconds " << (step>0 ? elapsed*(nsteps-step)/step : 0) << "\n";
+                    header(o, "faunus_resident_memory_bytes", "Resident memory of the process");
+                    o << "faunus_resident_memory_bytes " << residentMemory() << "\n";
+
+                    header(o, "faunus_move_acceptance_ratio", "Fraction of accepted moves");
+                    for (auto &m : sim.moves.vec)
+                        o << "faunus_move_acceptance_ratio" << label("move", m->name) << " " << m->acceptance() << "\n";
+                    header(o, "faunus_move_time_ratio", "Fraction of run time spent in move");
+                    for (auto &m : sim.moves.vec)
+                        o << "faunus_move_time_ratio" << label("move", m->name) << " " << m->relativeTime() << "\n";
+                    header(o, "faunus_energy_time_ratio", "Fraction of run time spent in energy term");
+                    for (auto &e : sim.energyTimes())
+                        o << "faunus_energy_time_ratio" << label("term", e.first) << " " << e.second << "\n";
+                    header(o, "faunus_analysis_time_ratio", "Fraction of run time spent in analysis");
+                    for (auto &a : analysis.vec)
+                        o << "faunus_analysis_time_ratio" << label("analysis", a->name) << " " << a->relativeTime() << "\n";
+
+                    std::string tmp = file + ".tmp";
+                    std::ofstream f(tmp);
+                    if (f) {
+                        f << o.str();
+                        f.close();
+                        std::rename(tmp.c_str(), file.c_str()); // atomic replace
+                    }
+                    tlast = now;
+                    steplast = step;
+                } //!< Write metrics if `interval` has passed or if `force` is true
+    };
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+    TEST_CASE("[Faunus] Telemetry")
+    {
+        struct Timed {
+            std::string name;
+            double acceptance() const { return 0.25; }
+            double relativeTime() const { return 0.5; }
+        };
+        struct {
+            struct { std::vector<std::shared_ptr<Timed>> vec; } moves;
+            std::vector<std::pair<std::string,double>> energyTimes() const { return {{"nonbonded", 0.1}}; }
+        } sim;
+        struct { std::vector<std::shared_ptr<Timed>> vec; } analysis;
+        sim.moves.vec = { std::make_shared<Timed>(Timed{"transrot"}), std::make_shared<Timed>(Timed{"odd \"name\\"}) };
+        analysis.vec = { std::make_shared<Timed>(Timed{"systemenergy"}) };
+
+        Telemetry t( {{"file", "_telemetry_test.prom"}, {"interval", 3600}} );
+        std::string file = MPI::prefix + "_telemetry_test.prom"; // rank specific under MPI
+        std::ofstream(file) << "stale\n";
+        t.update(sim, analysis, 10, 100);
+        std::string line;
+        std::getline(std::ifstream(file) >> std::ws, line);
+        CHECK( line=="stale" ); // interval has not passed
+
+        t.update(sim, analysis, 10, 100, true);
+        CHECK( !std::ifstream(file + ".tmp") ); // renamed into place
+        std::ifstream f(file);
+        std::regex help("# (HELP|TYPE) ([a-zA-Z_:][a-zA-Z0-9_:]*) .+"),
+            sample("([a-zA-Z_:][a-zA-Z0-9_:]*)(\\{[a-zA-Z_][a-zA-Z0-9_]*=\"([^\"\\\\]|\\\\.)*\"\\})? (\\S+)");
+        std::smatch m;
+        std::string typed; // name of last `# TYPE` line
+        int samples=0;
+        while (std::getline(f, line)) {
+            if (std::regex_match(line, m, help)) {
+                if (m[1]=="TYPE")
+                    typed = m[2];
+                continue;
+            }
+            REQUIRE( std::regex_match(line, m, sample) );
+            CHECK( m[1]==typed ); // samples follow their type
+            CHECK( std::isfinite(std::stod(m[4])) );
+            samples++;
+        }
+        CHECK( samples==5+2*2+1+1 );
+        std::ifstream g(file);
+        std::string all( (std::istreambuf_iterator<char>(g)), std::istreambuf_iterator<char>() );
+        CHECK( all.find("faunus_move_acceptance_ratio{move=\"odd \\\"name\\\\\"} 0.25")!=std::string::npos );
+        CHECK( all.find("faunus_progress_ratio 0.1\n")!=std::string::npos );
+        std::remove(file.c_str());
+    }
+#endif
+
     /**
      * @brief add documentation.....
      *
@@ -68,6 +68,7 @@ namespace Faunus {
                 int _nproc=1;      //!< Number of processors in communicator
                 int _rank=0;       //!< Rank of process
                 int _master=0;     //!< Rank number of the master
+                bool _owner=false; //!< True if this instance initialized MPI and must finalize it
         };
 
         static MPIController mpi;
@@ -81,7 +82,12 @@ namespace Faunus {
         //inline MPIController::MPIController(MPI_Comm c) : comm(MPI_COMM_WORLD), _master(0) {
         inline MPIController::MPIController() {
 #ifdef ENABLE_MPI
-            MPI_Init(NULL,NULL);
+            int initialized=0;
+            MPI_Initialized(&initialized);
+            if (!initialized) { // other instances share the environment of the first
+                MPI_Init(NULL,NULL);
+                _owner=true;
+            }
             MPI_Comm_size(comm, &_nproc);
             MPI_Comm_rank(comm, &_rank);
 #endif
@@ -95,7 +101,8 @@ namespace Faunus {
         inline MPIController::~MPIController() {
             f.close();
 #ifdef ENABLE_MPI
-            MPI_Finalize();
+            if (_owner)
+                MPI_Finalize();
 #endif
         }
 
@@ -14,6 +14,9 @@ namespace Faunus {
         struct PairPotentialBase {
             std::string name;
             std::string cite;
+            bool chargedependent=true; //!< False if the potential is unaffected by particle charges
+            bool chargelinear=false;   //!< True if the charge dependent part has the form q_i q_j f(r)
+            bool epsilonlinear=false;  //!< True if the energy is proportional to an interaction strength, epsilon
             virtual void to_json(json&) const=0;
             virtual void from_json(const json&)=0;
         }; //!< Base for all pair-potentials
@@ -43,6 +46,12 @@ namespace Faunus {
                         return first(a, b, r) + second(a, b, r);
                     }
 
+                template<class T, class U1=T1, class U2=T2>
+                    inline auto kernel(int i, int j, T qq, T r2) const
+                    -> decltype(std::declval<const U1&>().kernel(i,j,qq,r2) + std::declval<const U2&>().kernel(i,j,qq,r2)) {
+                        return first.kernel(i, j, qq, r2) + second.kernel(i, j, qq, r2);
+                    } //!< Sum of kernels; only available if both potentials have one
+
                 void from_json(const json &j) override {
                     first = j;
                     second = j;
@@ -51,6 +60,50 @@ namespace Faunus {
                 void to_json(json &j) const override { j = {first,second}; }
             };
 
+        template<class T, class Tparticle>
+            double chargeDependentPart(const T &pot, const Tparticle &a, const Tparticle &b, const Point &r) {
+                return pot.chargedependent ? pot(a, b, r) : 0;
+            } //!< Pair energy that depends on charges; zero for charge independent potentials
+
+        template<class T1, class T2, class Tparticle>
+            double chargeDependentPart(const CombinedPairPotential<T1,T2> &pot, const Tparticle &a, const Tparticle &b, const Point &r) {
+                return chargeDependentPart(pot.first, a, b, r) + chargeDependentPart(pot.second, a, b, r);
+            } //!< Sum of charge dependent parts of a combined potential
+
+        template<class T>
+            bool chargeLinear(const T &pot) {
+                return !pot.chargedependent || pot.chargelinear;
+            } //!< True if the charge dependent energy is q_i q_j f(r)
+
+        template<class T1, class T2>
+            bool chargeLinear(const CombinedPairPotential<T1,T2> &pot) {
+                return chargeLinear(pot.first) && chargeLinear(pot.second);
+            } //!< True if all charge dependent parts are of the form q_i q_j f(r)
+
+        template<class T, class Tparticle>
+            double epsilonLinearPart(const T &pot, const Tparticle &a, const Tparticle &b, const Point &r) {
+                return pot.epsilonlinear ? pot(a, b, r) : 0;
+            } //!< Pair energy proportional to epsilon; zero for e.g. hard spheres
+
+        template<class T1, class T2, class Tparticle>
+            double epsilonLinearPart(const CombinedPairPotential<T1,T2> &pot, const Tparticle &a, const Tparticle &b, const Point &r) {
+                return epsilonLinearPart(pot.first, a, b, r) + epsilonLinearPart(pot.second, a, b, r);
+            } //!< Sum of epsilon proportional parts of a combined potential
+
+        /**
+         * @brief True if `T` has a precision independent kernel
+         *
+         * Potentials between isotropic particles that depend only on the atom
+         * types, the charge product and the squared distance may implement
+         * `template<class T> T kernel(int id1, int id2, T q1q2, T r2) const`.
+         * It is used for single precision loops over structure-of-arrays data.
+         */
+        template<class T, class=void>
+            struct hasKernel : std::false_type {};
+
+        template<class T>
+            struct hasKernel<T, decltype(void(std::declval<const T&>().kernel(0, 0, 1.0f, 1.0f)))> : std::true_type {};
+
         template<class T1, class T2,
             class = typename std::enable_if<std::is_base_of<PairPotentialBase, T1>::value>::type,
             class = typename std::enable_if<std::is_base_of<PairPotentialBase, T2>::value>::type>
@@ -59,11 +112,13 @@ namespace Faunus {
                 } //!< Add two pair potentials
 
         struct Dummy : public PairPotentialBase {
-            Dummy() { name="dummy"; }
+            Dummy() { name="dummy"; chargedependent=false; }
             template<typename... T>
                 double operator()(const Particle<T...> &a, const Particle<T...> &b, const Point &r) const {
                     return 0;
                 }
+            template<class T>
+                T kernel(int, int, T, T) const { return 0; }
             void from_json(const json&) override {}
             void to_json(json&) const override {}
         }; //!< A dummy pair potential that always returns zero
@@ -72,7 +127,15 @@ namespace Faunus {
             struct SigmaEpsilonTable {
                 enum Mixers {LB};
                 Mixers mixer = LB;
-                PairMatrix<double> s2,eps; // matrix of sigma_ij^2 and 4*eps_ij
+                struct Params {
+                    double s2=0;  //!< sigma_ij^2
+                    double eps=0; //!< 4*epsilon_ij
+                }; //!< Interleaved parameters for a single pair
+                PairMatrix<Params> m; // one contiguous block of pair parameters
+                const Params& operator()(int i, int j) const { return m(i,j); } //!< Parameters for pair of atom types
+                double s2(int i, int j) const { return m(i,j).s2; } //!< sigma_ij^2
+                double eps(int i, int j) const { return m(i,j).eps; } //!< 4*epsilon_ij
+                void set(int i, int j, double s2, double eps) { m.set(i, j, {s2, eps}); }
             }; //!< Table of sigma and epsilons
 
         template<typename Tparticle>
@@ -92,14 +155,12 @@ namespace Faunus {
                         throw std::runtime_error("unknown mixing rule");
                 }
                 size_t n=atoms<Tparticle>.size(); // number of atom types
-                m.s2.resize(n); // not required...
-                m.eps.resize(n);// ...but possible reduced mem. fragmentation
+                m.m.resize(n); // not required but avoids repeated reallocation
                 for (auto &i : atoms<Tparticle>)
                     for (auto &j : atoms<Tparticle>) {
                         double sigma, epsilon; // mixed values
                         std::tie( sigma, epsilon ) = mixerFunc(i.sigma, j.sigma, i.eps, j.eps);
-                        m.s2.set(  i.id(), j.id(), sigma*sigma );
-                        m.eps.set( i.id(), j.id(), 4*epsilon ); // should already be in kT
+                        m.set( i.id(), j.id(), sigma*sigma, 4*epsilon ); // epsilon should already be in kT
                     }
 
                 // custom eps/sigma for specific pairs
@@ -111,8 +172,8 @@ namespace Faunus {
                             if (v.size()==2) {
                                 int id1 = (*findName( atoms<Tparticle>, v[0])).id();
                                 int id2 = (*findName( atoms<Tparticle>, v[1])).id();
-                                m.s2.set( id1, id2, std::pow( it.value().at("sigma").get<double>(), 2) );
-                                m.eps.set(id1, id2, 4*it.value().at("eps").get<double>() * 1.0_kJmol);
+                                m.set( id1, id2, std::pow( it.value().at("sigma").get<double>(), 2),
+                                        4*it.value().at("eps").get<double>() * 1.0_kJmol );
                             } else
                                 std::runtime_error("custom epsilon/sigma parameters require exactly two space-separated atoms");
                         }
@@ -125,8 +186,8 @@ namespace Faunus {
                 j["mixing"] = "LB";
                 j["epsilon unit"] = "kJ/mol";
                 auto& _j = j["custom"];
-                for (size_t i=0; i<m.eps.size(); i++)
-                    for (size_t j=0; j<m.eps.size(); j++)
+                for (size_t i=0; i<m.m.size(); i++)
+                    for (size_t j=0; j<m.m.size(); j++)
                         if (i>=j) {
                             auto str = atoms<Tparticle>[i].name+" "+atoms<Tparticle>[j].name;
                             _j[str] = { {"eps", m.eps(i,j)/4.0_kJmol}, {"sigma", std::sqrt(m.s2(i,j))}  };
@@ -139,24 +200,38 @@ namespace Faunus {
          */
         template<typename Tparticle>
             struct LennardJones : public PairPotentialBase {
-                LennardJones(const std::string &name="lennardjones"s) { PairPotentialBase::name=name; }
+                LennardJones(const std::string &name="lennardjones"s) {
+                    PairPotentialBase::name=name;
+                    chargedependent=false;
+                    epsilonlinear=true;
+                }
                 SigmaEpsilonTable<Tparticle> m; // table w. sigma_ij^2 and 4xepsilon
 
                 template<typename... T>
                     Point force(const Particle<T...> &a, const Particle<T...> &b, double r2, const Point &p) const {
-                        double s6=powi<3>( m.s2(a.id,b.id) );
+                        auto &q = m(a.id,b.id);
+                        double s6=powi<3>( q.s2 );
                         double r6=r2*r2*r2;
                         double r14=r6*r6*r2;
-                        return 6.*m.eps(a.id,b.id) * s6 * (2*s6-r6) / r14 * p;
+                        return 6.*q.eps * s6 * (2*s6-r6) / r14 * p;
                     }
 
                 template<typename... T>
                     double operator()(const Particle<T...> &a, const Particle<T...> &b, const Point &r) const {
-                        double x=m.s2(a.id,b.id)/r.squaredNorm(); //s2/r2
+                        auto &q = m(a.id,b.id);
+                        double x=q.s2/r.squaredNorm(); //s2/r2
                         x=x*x*x; // s6/r6
-                        return m.eps(a.id,b.id) * (x*x - x);
+                        return q.eps * (x*x - x);
                     }
 
+                template<class T>
+                    inline T kernel(int i, int j, T, T r2) const {
+                        auto &q = m(i,j);
+                        T x=T(q.s2)/r2; //s2/r2
+                        x=x*x*x; // s6/r6
+                        return T(q.eps) * (x*x - x);
+                    } //!< Energy from atom types and squared distance in precision T
+
                 void to_json(json &j) const override { j = m; }
                 void from_json(const json &j) override { m = j; }
             };
@@ -182,16 +257,18 @@ namespace Faunus {
                     inline WeeksChandlerAndersen(const std::string &name="wca") {
                         base::name=name;
                         base::cite="doi:ct4kh9";
+                        base::epsilonlinear=false; // purely repulsive reference; not scaled as an attraction
                     }
 
                     template<typename... T>
                         inline double operator() (const Particle<T...> &a, const Particle<T...> &b, double r2) const {
-                            double x=m.s2(a.id,b.id); // s^2
+                            auto &q = m(a.id,b.id);
+                            double x=q.s2; // s^2
                             if (r2>x*twototwosixth)
                                 return 0;
                             x=x/r2;  // (s/r)^2
                             x=x*x*x;// (s/r)^6
-                            return m.eps(a.id,b.id)*(x*x - x + onefourth);
+                            return q.eps*(x*x - x + onefourth);
                         }
 
                     template<typename... T>
@@ -199,25 +276,41 @@ namespace Faunus {
                             return operator()(a,b,r.squaredNorm());
                         }
 
+                    template<class T>
+                        inline T kernel(int i, int j, T, T r2) const {
+                            auto &q = m(i,j);
+                            T s2=T(q.s2), x=s2/r2; // (s/r)^2
+                            x=x*x*x;// (s/r)^6
+                            return (r2>s2*T(twototwosixth)) ? T(0) : T(q.eps)*(x*x - x + T(onefourth));
+                        } //!< Energy from atom types and squared distance in precision T
+
                     template<typename... T>
                         Point force(const Particle<T...> &a, const Particle<T...> &b, double r2, const Point &p) const {
-                            double x=m.s2(a.id,b.id); // s^2
+                            auto &q = m(a.id,b.id);
+                            double x=q.s2; // s^2
                             if (r2>x*twototwosixth)
                                 return Point(0,0,0);
                             x=x/r2;  // (s/r)^2
                             x=x*x*x;// (s/r)^6
-                            return m.eps(a.id,b.id)*6*(2*x*x - x)/r2*p;
+                            return q.eps*6*(2*x*x - x)/r2*p;
                         }
             }; // Weeks-Chandler-Andersen potential
 
 
         struct Coulomb : public PairPotentialBase {
-            Coulomb(const std::string &name="coulomb") { PairPotentialBase::name=name; }
+            Coulomb(const std::string &name="coulomb") {
+                PairPotentialBase::name=name;
+                chargelinear=true;
+            }
             double lB; //!< Bjerrum length
             template<typename... T>
                 double operator()(const Particle<T...> &a, const Particle<T...> &b, const Point &r) const {
                     return lB * a.charge * b.charge / r.norm();
                 }
+            template<class T>
+                T kernel(int, int, T qq, T r2) const {
+                    return T(lB) * qq / std::sqrt(r2);
+                } //!< Energy from charge product and squared distance in precision T
             void to_json(json &j) const override { j["epsr"] = pc::lB(lB); }
             void from_json(const json &j) override { lB = pc::lB( j.at("epsr") ); }
         };
@@ -227,6 +320,7 @@ namespace Faunus {
                 PairMatrix<double> d2; // matrix of (r1+r2)^2
                 HardSphere(const std::string &name="hardsphere") {
                     PairPotentialBase::name=name;
+                    chargedependent=false;
                     for (auto &i : atoms<Tparticle>)
                         for (auto &j : atoms<Tparticle>)
                             d2.set( i.id(), j.id(), std::pow((i.sigma+j.sigma)/2,2));
@@ -242,6 +336,7 @@ namespace Faunus {
             double f=0, s=0, e=0;
             inline RepulsionR3(const std::string &name="repulsionr3") {
                 PairPotentialBase::name = name;
+                chargedependent = false;
             }
             void from_json(const json &j) override {
                 f = j.value("prefactor", 1.0);
@@ -280,7 +375,11 @@ namespace Faunus {
         class CosAttract : public PairPotentialBase {
             double eps, wc, rc, rc2, c, rcwc2;
             public:
-            CosAttract(const std::string &name="cos2") { PairPotentialBase::name=name; }
+            CosAttract(const std::string &name="cos2") {
+                PairPotentialBase::name=name;
+                chargedependent=false;
+                epsilonlinear=true;
+            }
 
             /**
              * @todo
@@ -331,6 +430,108 @@ namespace Faunus {
             }
         };
 
+        /**
+         * @brief Closest vector between two line segments
+         *
+         * The segments have lengths `l1` and `l2`, directions `u1` and `u2` (unit vectors)
+         * and are centered at `r` and the origin, respectively. The returned vector points from
+         * the closest point on the second segment to the closest point on the first.
+         * The kernel is branch-light, handles (near) parallel segments and reduces to the
+         * ordinary distance vector for zero lengths, see Ericson, Real-Time Collision Detection (2005).
+         */
+        inline Point segmentDistance(const Point &r, const Point &u1, double l1, const Point &u2, double l2) {
+            auto clamp = [](double x) { return std::min(1.0, std::max(0.0, x)); };
+            const double eps = 1e-12;
+            Point d1 = u1*l1, d2 = u2*l2;          // segment vectors
+            Point r0 = r - 0.5*(d1 - d2);         // start of segment 1 relative to start of segment 2
+            double a = d1.squaredNorm(), e = d2.squaredNorm(), f = d2.dot(r0);
+            double s=0, t=0;
+            if (a>eps) {
+                double c = d1.dot(r0);
+                if (e>eps) {
+                    double b = d1.dot(d2), denom = a*e - b*b;
+                    if (denom>eps*a*e) // not parallel
+                        s = clamp( (b*f - c*e) / denom );
+                    t = (b*s + f) / e;
+                    if (t<0) {
+                        t = 0;
+                        s = clamp(-c/a);
+                    } else if (t>1) {
+                        t = 1;
+                        s = clamp( (b-c)/a );
+                    }
+                } else
+                    s = clamp(-c/a);
+            } else if (e>eps)
+                t = clamp(f/e);
+            return r0 + d1*s - d2*t;
+        }
+
+        template<class T, typename std::enable_if<std::is_base_of<Cigar,T>::value, int>::type=0>
+            Point segmentDistance(const T &a, const T &b, const Point &r) {
+                return segmentDistance(r, a.scdir, a.sclen, b.scdir, b.sclen);
+            } //!< Closest vector between spherocylinder axes
+
+        template<class T, typename std::enable_if<!std::is_base_of<Cigar,T>::value, int>::type=0>
+            Point segmentDistance(const T&, const T&, const Point &r) { return r; } //!< Point particles
+
+        template<class T, typename std::enable_if<std::is_base_of<Cigar,T>::value, int>::type=0>
+            double axisAlignment(const T &a, const T &b) {
+                double x = a.scdir.dot(b.scdir);
+                return x*x;
+            } //!< Squared cosine of angle between spherocylinder axes
+
+        template<class T, typename std::enable_if<!std::is_base_of<Cigar,T>::value, int>::type=0>
+            double axisAlignment(const T&, const T&) { return 1; } //!< Point particles
+
+        /**
+         * @brief Spherocylinder version of an isotropic pair potential
+         *
+         * The isotropic potential is evaluated at the closest distance between the
+         * spherocylinder axes given by the `Cigar` properties `scdir` and `sclen`.
+         * With `Taligned=true` the energy is further weighted by
+         * @f$ (\hat{u}_1\cdot\hat{u}_2)^2 @f$ to favour parallel alignment (patchy attraction).
+         * For particles without `Cigar` properties, the isotropic potential is recovered.
+         */
+        template<class Tpairpot, bool Taligned=false>
+            struct SpheroCylinder : public PairPotentialBase {
+                Tpairpot pot; //!< Isotropic potential evaluated at the closest axis distance
+                SpheroCylinder(const std::string &name="spherocylinder") {
+                    PairPotentialBase::name=name;
+                    chargedependent=false;
+                }
+                template<class Tparticle>
+                    double operator()(const Tparticle &a, const Tparticle &b, const Point &r) const {
+                        double u = pot(a, b, segmentDistance(a, b, r));
+                        return Taligned ? axisAlignment(a,b) * u : u;
+                    }
+                void to_json(json &j) const override { j = pot; }
+                void from_json(const json &j) override { pot = j; }
+            };
+
+#ifdef DOCTEST_LIBRARY_INCLUDED
+        TEST_CASE("[Faunus] SpheroCylinder")
+        {
+            using doctest::Approx;
+            Point x(1,0,0), y(0,1,0);
+            CHECK( segmentDistance(Point(0,2,0), x, 4, x, 4).norm() == Approx(2) );   // side by side
+            CHECK( segmentDistance(Point(5,0,0), x, 2, x, 2).norm() == Approx(3) );   // end to end
+            CHECK( segmentDistance(Point(3,0,0), y, 4, x, 2).norm() == Approx(2) );   // T-shape
+            CHECK( segmentDistance(Point(0,0,1.5), x, 10, y, 10).z() == Approx(1.5) ); // crossed
+            CHECK( segmentDistance(Point(1,2,3), x, 0, y, 0) == Point(1,2,3) );       // spheres
+
+            typedef Particle<Radius, Charge, Dipole, Cigar> T;
+            T a, b;
+            a.sclen = b.sclen = 10;
+            SpheroCylinder<CosAttract,true> u = R"({"eps":1.0, "rc":2.0, "wc":1.0})"_json;
+            Point r(0,2,0);
+            CHECK( u(a,b,r) == Approx(-1.0_kJmol) ); // parallel, within rc
+            b.scdir = Point(0,0,1);
+            CHECK( u(a,b,r) == Approx(0) ); // perpendicular
+        }
+#endif
+
+
         /**
          * @brief Charge-nonpolar pair interaction
          */
@@ -341,7 +542,10 @@ namespace Faunus {
                     PairMatrix<double> m_neutral, m_charged;
 
                 public:
-                    Polarizability (const std::string &name="polar") { PairPotentialBase::name=name; }
+                    Polarizability (const std::string &name="polar") {
+                        PairPotentialBase::name=name;
+                        chargelinear=false;
+                    }
 
                     inline void from_json(const json &j) override {
                         epsr = j.at("epsr").get<double>();
@@ -518,18 +722,25 @@ namespace Faunus {
             double selfenergy_prefactor;
             double lB, depsdt, rc, rc2, rc1i, epsr, epsrf, alpha, kappa, I;
             int order;
+            std::string cachekey; // identifies the splitting function table
+            std::vector<float> sfgrid; // splitting function on an even grid in [0:1] for `kernel()`
+
+            template<class Tfunc>
+                Tabulate::TabulatorBase<double>::data generate(Tfunc f) {
+                    return Tabulate::tableCache<double>().get( cachekey, [&]() { return sf.generate(f, 0, 1); } );
+                } //!< Tabulate splitting function in [0:1] or reuse an identical, cached table
 
             void sfYukawa(const json &j) {
                 kappa = 1.0 / j.at("debyelength").get<double>();
                 I = kappa*kappa / ( 8.0*lB*pc::pi*pc::Nav/1e27 );
-                table = sf.generate( [&](double q) { return std::exp(-q*rc*kappa) - std::exp(-kappa*rc); }, 0, 1 ); // q=r/Rc
+                table = generate( [&](double q) { return std::exp(-q*rc*kappa) - std::exp(-kappa*rc); } ); // q=r/Rc
                 // we could also fill in some info std::string or JSON output...
             }
 
             void sfReactionField(const json &j) {
                 epsrf = j.at("eps_rf");
-                table = sf.generate( [&](double q) { return 1 + (( epsrf - epsr ) / ( 2 * epsrf + epsr ))*q*q*q
-                        - 3 * ( epsrf / ( 2 * epsrf + epsr ))*q ; }, 0, 1);
+                table = generate( [&](double q) { return 1 + (( epsrf - epsr ) / ( 2 * epsrf + epsr ))*q*q*q
+                        - 3 * ( epsrf / ( 2 * epsrf + epsr ))*q ; } );
                 calcDielectric = [&](double M2V) {
                     if(epsrf > 1e10)
                         return 1 + 3*M2V;
@@ -548,7 +759,7 @@ namespace Faunus {
             void sfQpotential(const json &j)
             {
                 order = j.value("order",300);
-                table = sf.generate( [&](double q) { return qPochhammerSymbol( q, 1, order ); }, 0, 1 );
+                table = generate( [&](double q) { return qPochhammerSymbol( q, 1, order ); } );
                 calcDielectric = [&](double M2V) { return 1 + 3*M2V; };
                 selfenergy_prefactor = 0.5;
             }
@@ -556,21 +767,21 @@ namespace Faunus {
             void sfYonezawa(const json &j)
             {
                 alpha = j.at("alpha");
-                table = sf.generate( [&](double q) { return 1 - std::erfc(alpha*rc)*q + q*q; }, 0, 1 );
+                table = generate( [&](double q) { return 1 - std::erfc(alpha*rc)*q + q*q; } );
                 calcDielectric = [&](double M2V) { return 1 + 3*M2V; };
                 selfenergy_prefactor = erf(alpha*rc);
             }
 
             void sfFanourgakis(const json &j) {
-                table = sf.generate( [&](double q) { return 1 - 1.75*q + 5.25*pow(q,5) - 7*pow(q,6) + 2.5*pow(q,7); }, 0, 1 );
+                table = generate( [&](double q) { return 1 - 1.75*q + 5.25*pow(q,5) - 7*pow(q,6) + 2.5*pow(q,7); } );
                 calcDielectric = [&](double M2V) { return 1 + 3*M2V; };
                 selfenergy_prefactor = 0.875;
             }
 
             void sfFennel(const json &j) {
                 alpha = j.at("alpha");
-                table = sf.generate( [&](double q) { return (erfc(alpha*rc*q) - std::erfc(alpha*rc)*q + (q-1.0)*q*(std::erfc(alpha*rc)
-                                + 2 * alpha * rc / std::sqrt(pc::pi) * std::exp(-alpha*alpha*rc*rc))); }, 0, 1 );
+                table = generate( [&](double q) { return (erfc(alpha*rc*q) - std::erfc(alpha*rc)*q + (q-1.0)*q*(std::erfc(alpha*rc)
+                                + 2 * alpha * rc / std::sqrt(pc::pi) * std::exp(-alpha*alpha*rc*rc))); } );
                 calcDielectric = [&](double M2V) { double T = erf(alpha*rc) - (2 / (3 * sqrt(pc::pi)))
                     * exp(-alpha*alpha*rc*rc) * (alpha*alpha*rc*rc * alpha*alpha*rc*rc + 2.0 * alpha*alpha*rc*rc + 3.0);
                     return (((T + 2.0) * M2V + 1.0)/ ((T - 1.0) * M2V + 1.0)); };
@@ -579,7 +790,7 @@ namespace Faunus {
 
             void sfEwald(const json &j) {
                 alpha = j.at("alpha");
-                table = sf.generate( [&](double q) { return std::erfc(alpha*rc*q); }, 0, 1 );
+                table = generate( [&](double q) { return std::erfc(alpha*rc*q); } );
                 calcDielectric = [&](double M2V) {
                     double T = std::erf(alpha*rc) - (2 / (3 * sqrt(pc::pi)))
                         * std::exp(-alpha*alpha*rc*rc) * ( 2*alpha*alpha*rc*rc + 3);
@@ -590,7 +801,7 @@ namespace Faunus {
 
             void sfWolf(const json &j) {
                 alpha = j.at("alpha");
-                table = sf.generate( [&](double q) { return (erfc(alpha*rc*q) - erfc(alpha*rc)*q); }, 0, 1 );
+                table = generate( [&](double q) { return (erfc(alpha*rc*q) - erfc(alpha*rc)*q); } );
                 calcDielectric = [&](double M2V) { double T = erf(alpha*rc) - (2 / (3 * sqrt(pc::pi))) * exp(-alpha*alpha*rc*rc)
                     * ( 2.0 * alpha*alpha*rc*rc + 3.0);
                     return (((T + 2.0) * M2V + 1.0)/ ((T - 1.0) * M2V + 1.0));};
@@ -598,13 +809,16 @@ namespace Faunus {
             }
 
             void sfPlain(const json &j, double val=1) {
-                table = sf.generate( [&](double q) { return val; }, 0, 1 );
+                table = generate( [&](double q) { return val; } );
                 calcDielectric = [&](double M2V) { return (2.0*M2V + 1.0)/(1.0 - M2V); };
                 selfenergy_prefactor = 0.0;
             }
 
             public:
-            CoulombGalore(const std::string &name="coulomb") { PairPotentialBase::name=name; }
+            CoulombGalore(const std::string &name="coulomb") {
+                PairPotentialBase::name=name;
+                chargelinear=true;
+            }
 
             void from_json(const json &j) override {
                 try {
@@ -617,6 +831,7 @@ namespace Faunus {
                     depsdt = j.value("depsdt", -0.368*pc::temperature/epsr);
                     sf.setTolerance(
                             j.value("utol",1e-5),j.value("ftol",1e-2) );
+                    cachekey = "coulombgalore " + j.dump(); // all input that may affect the table
 
                     if (type=="reactionfield") sfReactionField(j);
                     if (type=="fanourgakis") sfFanourgakis(j);
@@ -630,6 +845,11 @@ namespace Faunus {
                     if (type=="wolf") sfWolf(j);
                     if ( table.empty() )
                         throw std::runtime_error(name + ": unknown coulomb type '" + type + "'" );
+
+                    sfgrid.resize(sfpoints+1);
+                    for (int i=0; i<=sfpoints; i++)
+                        sfgrid[i] = sf.eval( table, std::max(i, 1) / double(sfpoints) );
+                    sfgrid[0] = sf.eval( table, 1e-6 / sfpoints ); // the table is defined in ]0:1]
                 }
 
                 catch ( std::exception &e ) {
@@ -652,6 +872,17 @@ namespace Faunus {
                     return operator()(a,b,r.squaredNorm());
                 }
 
+            static constexpr int sfpoints=4096; //!< Number of intervals in the linearly interpolated splitting function
+
+            template<class T>
+                inline T kernel(int, int, T qq, T r2) const {
+                    T r = std::sqrt(r2);
+                    T x = std::min( r * T(rc1i*sfpoints), T(sfpoints) ); // branch free for vectorization
+                    int k = std::min( int(x), sfpoints-1 );
+                    T s = sfgrid[k] + (x-k) * (sfgrid[k+1]-sfgrid[k]);
+                    return (r2 < T(rc2)) ? T(lB) * qq / r * s : T(0);
+                } //!< Energy from charge product and squared distance in precision T w. interpolated splitting function
+
             template<typename... T>
                 Point force(const Particle<T...> &a, const Particle<T...> &b, double r2, const Point &p) const {
                     if (r2 < rc2) {
@@ -715,7 +946,7 @@ namespace Faunus {
         template<class T /** particle type */>
             class FunctorPotential : public PairPotentialBase {
                 typedef std::function<double(const T&, const T&, const Point&)> uFunc;
-                PairMatrix<uFunc,true> umatrix; // matrix with potential for each atom pair
+                PairMatrix<uFunc> umatrix; // matrix with potential for each atom pair
                 json _j; // storage for input json
 
                 uFunc combineFunc(const json &j) const {
@@ -732,6 +963,9 @@ namespace Faunus {
                                     if (it.key()=="lennardjones") _u = LennardJones<T>() = i;
                                     if (it.key()=="repulsionr3") _u = RepulsionR3() = i;
                                     if (it.key()=="wca") _u = WeeksChandlerAndersen<T>() = i;
+                                    if (it.key()=="hardspherocylinder") _u = SpheroCylinder<HardSphere<T>>(it.key()) = i;
+                                    if (it.key()=="wcaspherocylinder") _u = SpheroCylinder<WeeksChandlerAndersen<T>>(it.key()) = i;
+                                    if (it.key()=="cos2spherocylinder") _u = SpheroCylinder<CosAttract,true>(it.key()) = i;
                                     if (it.key()=="pm") _u = Coulomb() + HardSphere<T>() = it.value();
                                     if (it.key()=="pmwca") _u = Coulomb() + WeeksChandlerAndersen<T>() = it.value();
                                     if (_u!=nullptr) // if found, sum them into new function object
@@ -925,6 +1159,10 @@ namespace Faunus {
             json val;
             b->to_json(val);
             val["index"] = b->index;
+            if (b->exclude) {
+                val["exclude"] = true;
+                val["keepelectrostatics"] = b->keepelectrostatics;
+            }
             j = {{ b->name(), val }};
         }
 
@@ -940,6 +1178,8 @@ namespace Faunus {
                         throw std::runtime_error("unknown bond type: " + key);
                     b->from_json( val );
                     b->index = val.at("index").get<decltype(b->index)>();
+                    b->exclude = val.value("exclude", b->exclude);
+                    b->keepelectrostatics = val.value("keepelectrostatics", b->keepelectrostatics);
                     if (b->index.size() != b->numindex())
                         throw std::runtime_error("exactly " + std::to_string(b->numindex()) + " indices required for " + b->name());
                     return;
@@ -1,5 +1,11 @@
 #pragma once
+#include <numeric>
+#include <cstdint>
 #include "core.h"
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
 #include "geometry.h"
 #include "group.h"
 
@@ -17,11 +23,14 @@ namespace Faunus {
         double du=0;        //!< Additional energy change not captured by Hamiltonian
         bool dNpart=false;      //!< Is the size of groups partially changed
 
+        enum Property {POSITION=1, CHARGE=2, ORIENTATION=4, ACTIVITY=8, ANYPROPERTY=15}; //!< Particle properties
+
         struct data {
             bool dNpart=false;      //!< Is the size of groups partially changed
             int index; //!< Touched group index
             bool internal=false; //!< True is the internal energy/config has changed
             bool all=false; //!< Set to `true` if all particles in group have been updated
+            int property=ANYPROPERTY; //!< Bitmask of changed particle properties, see `Change::Property`
             std::vector<int> atoms; //!< Touched atom index w. respect to `Group::begin()`
 
             bool operator<( const data & a ) const{
@@ -31,10 +40,24 @@ namespace Faunus {
 
         std::vector<data> groups; //!< Touched groups by index in group vector
 
-        auto touchedGroupIndex() {
-            // skitfunktion
-            return ranges::view::transform(groups, [](data &i) -> int {return i.index;});
-        } //!< List of moved groups (index)
+        std::vector<int> touchedGroupIndex() const {
+            std::vector<int> index;
+            index.reserve( groups.size() );
+            for (auto &d : groups)
+                index.push_back(d.index);
+            std::sort( index.begin(), index.end() );
+            index.erase( std::unique( index.begin(), index.end() ), index.end() );
+            return index;
+        } //!< Sorted list of moved groups (index)
+
+        bool only(int mask) const {
+            if (dV || all || dNpart || groups.empty())
+                return false;
+            for (auto &d : groups)
+                if (d.property & ~mask)
+                    return false;
+            return true;
+        } //!< True if changed groups have no other properties changed than those in `mask`
 
         void clear()
         {
@@ -80,18 +103,31 @@ namespace Faunus {
             Tpvec p;       //!< Particle vector
             Tgvec groups;  //!< Group vector
             Tgeometry geo; //!< Container geometry
+            std::vector<int> groupindex; //!< Group index of each particle in `p` (incl. inactive)
 
             auto positions() const {
                return ranges::view::transform(p, [](auto &i) -> const Point& {return i.pos;});
             } //!< Iterable range with positions 
 
+            auto activeParticles() {
+                return groups | ranges::view::join;
+            } //!< Iterable range with active particles only; inactive group capacity is skipped
+
             enum Selection {ALL, ACTIVE, INACTIVE};
 
             void clear() {
                 p.clear();
                 groups.clear();
+                groupindex.clear();
             } //!< Clears particle and molecule list
 
+            void updateGroupIndex() {
+                groupindex.resize( p.size() );
+                for (size_t k=0; k<groups.size(); k++)
+                    std::fill( groupindex.begin() + std::distance(p.begin(), groups[k].begin()),
+                            groupindex.begin() + std::distance(p.begin(), groups[k].trueend()), int(k) );
+            } //!< Rebuild particle-to-group index table (Order N complexity)
+
             /*
              * The following is considered:
              *
@@ -113,6 +149,7 @@ namespace Faunus {
                     g.atomic = molecules<Tpvec>.at(molid).atomic;
 
                     if (g.atomic==false) {
+                        g.updateMass();
                         g.cm = Geometry::massCenter(in.begin(), in.end(), geo.boundaryFunc, -in.begin()->pos);
                         Point cm = Geometry::massCenter(g.begin(), g.end(), geo.boundaryFunc, -g.cm);
                         if (geo.sqdist(g.cm, cm)>1e-9)
@@ -120,6 +157,7 @@ namespace Faunus {
                     }
 
                     groups.push_back(g);
+                    groupindex.insert( groupindex.end(), in.size(), int(groups.size())-1 );
                     assert( in.size() == groups.back().capacity() );
                 }
             } //!< Safely add particles and corresponding group to back
@@ -152,8 +190,21 @@ namespace Faunus {
             } //!< Range with all atoms of type `atomid` (complexity: order N)
 
             auto findGroupContaining(const Tparticle &i) {
-                return std::find_if( groups.begin(), groups.end(), [&i](auto &g){ return g.contains(i); });
-            } //!< Finds the groups containing the given atom
+                if (groupindex.size() != p.size()) // table out of date; fall back to linear search
+                    return std::find_if( groups.begin(), groups.end(), [&i](auto &g){ return g.contains(i); });
+                if (!p.empty()) {
+                    auto d = &i - &p.front();
+                    if (d>=0 && d<(decltype(d))p.size()) {
+                        int k = groupindex[d];
+                        if (k>=0 && size_t(k)<groups.size()) { // table may refer to removed groups
+                            auto it = groups.begin() + k;
+                            if (it->contains(i))
+                                return it;
+                        }
+                    }
+                }
+                return groups.end();
+            } //!< Finds the group containing the given atom; `groups.end()` if inactive or not in `p` (Order 1 complexity)
 
             void sync(Tspace &other, const Tchange &change) {
 
@@ -169,6 +220,7 @@ namespace Faunus {
                     p = other.p; // copy all positions
                     assert( p.begin() != other.p.begin() && "deep copy problem");
                     groups = other.groups;
+                    groupindex = other.groupindex;
 
                     if (!groups.empty())
                         if (groups.front().begin() == other.p.begin())
@@ -194,6 +246,44 @@ namespace Faunus {
                 assert( p.begin() != other.p.begin());
             } //!< Copy differing data from other (o) Space using Change object
 
+            void updateMoments() {
+                auto vdist = [this](const Point &a, const Point &b) { return geo.vdist(a,b); };
+                for (auto &g : groups)
+                    if (!g.atomic)
+                        g.updateMoments(vdist);
+            } //!< Recalculate moment sums of all molecular groups
+
+            void updateMoments(const Tspace &old, const Tchange &change) {
+                if (change.all || change.dV) {
+                    updateMoments();
+                    return;
+                }
+                auto vdist = [this](const Point &a, const Point &b) { return geo.vdist(a,b); };
+                double drift = 0.25*geo.getLength().minCoeff(); // rebase if the reference is this far behind
+                for (auto &d : change.groups) {
+                    auto &g = groups.at(d.index);
+                    auto &gold = old.groups.at(d.index);
+                    if (g.atomic)
+                        continue;
+                    if (d.all && !d.internal && !d.dNpart && g.moments.valid && g.size()==gold.size()) {
+                        if ( g.moments.m<=0 || (g.moments.mr/g.moments.m).norm() > drift )
+                            g.updateMoments(vdist);
+                        continue; // rigid move; `translate()` and `rotate()` have updated the sums
+                    }
+                    if (d.all || d.atoms.empty() || d.dNpart || !gold.moments.valid || g.size()!=gold.size()) {
+                        g.updateMoments(vdist);
+                        continue;
+                    }
+                    g.moments = gold.moments;
+                    for (int i : d.atoms) {
+                        g.addMoments( *(gold.begin()+i), vdist, -1 );
+                        g.addMoments( *(g.begin()+i), vdist );
+                    }
+                    if ( g.moments.m<=0 || (g.moments.mr/g.moments.m).norm() > drift )
+                        g.updateMoments(vdist);
+                }
+            } //!< Update moment sums of changed molecular groups from the old state (Order 1 per changed atom or rigid group)
+
             /*
              * Scales:
              * - positions of free atoms
@@ -236,6 +326,55 @@ namespace Faunus {
             } //!< scale space to new volume
 
 
+            size_t memory() const {
+                return memsize(p) + memsize(groups) + memsize(groupindex);
+            } //!< Memory used by particles, groups and lookup tables (bytes)
+
+            std::vector<int> domainOrder() const {
+                int d;
+                geo.getLength().maxCoeff(&d);
+                std::vector<int> order(groups.size());
+                std::iota(order.begin(), order.end(), 0);
+                auto key = [&](int i) {
+                    auto &g = groups[i];
+                    return (g.atomic || g.empty()) ? pc::infty : g.cm[d];
+                };
+                std::stable_sort(order.begin(), order.end(), [&](int a, int b){ return key(a)<key(b); });
+                return order;
+            } //!< Group index sorted by mass center along the longest box side; atomic and empty groups last
+
+            size_t placeMemory() {
+                size_t n=0;
+#if defined(__linux__) && defined(SYS_move_pages) && defined(SYS_getcpu)
+                const int MPOL_MF_MOVE=2; // from <numaif.h>
+                const uintptr_t pagesize = sysconf(_SC_PAGESIZE);
+                auto order = domainOrder();
+#pragma omp parallel for schedule(static) reduction(+:n)
+                for (size_t k=0; k<order.size(); k++) {
+                    auto &g = groups[order[k]];
+                    unsigned int cpu, node;
+                    if (g.capacity()==0 || syscall(SYS_getcpu, &cpu, &node, nullptr)!=0)
+                        continue;
+                    auto first = reinterpret_cast<uintptr_t>( &*g.begin() );
+                    auto last = first + sizeof(Tparticle)*g.capacity();
+                    std::vector<void*> pages;
+                    for (uintptr_t a = first/pagesize*pagesize; a<last; a+=pagesize)
+                        pages.push_back( reinterpret_cast<void*>(a) );
+                    std::vector<int> nodes(pages.size(), node), status(pages.size());
+                    if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nodes.data(), status.data(), MPOL_MF_MOVE)==0)
+                        n += pages.size();
+                }
+#endif
+                return n;
+            } /**
+               * @brief Move the memory pages of each group to the NUMA node of the thread that
+               * handles it in static, domain ordered loops (Linux only)
+               * @returns Number of pages whose placement was requested (zero if not supported)
+               *
+               * Particles are not reallocated so references and iterators stay valid.
+               * Pages shared by neighbouring groups end up with one of them.
+               */
+
             json info() {
                 json j = {
                     {"number of particles", p.size()},
@@ -307,6 +446,7 @@ namespace Faunus {
                         if (begin != spc.p.end())
                             throw std::runtime_error("load error");
                     }
+                    spc.updateGroupIndex();
                 }
                 // check correctness of molecular mass centers
                 for (auto &i : spc.groups)
@@ -405,10 +545,16 @@ namespace Faunus {
         typedef Particle<Radius, Charge, Dipole, Cigar> Tparticle;
         typedef Space<Geometry::Cuboid, Tparticle> Tspace;
         Tspace spc1;
+        spc1.geo = R"( {"length": [10,10,10]} )"_json;
+        auto atombackup = atoms<Tparticle>;
+        auto molbackup = molecules<typename Tspace::Tpvec>;
+        molecules<typename Tspace::Tpvec>.clear();
+        molecules<typename Tspace::Tpvec>.resize(2);
 
         // check molecule insertion
-        atoms<typename Tspace::Tpvec>.resize(2);
-        CHECK( atoms<typename Tspace::Tpvec>.at(0).mw == 1);
+        atoms<Tparticle>.clear();
+        atoms<Tparticle>.resize(2);
+        CHECK( atoms<Tparticle>.at(0).mw == 1);
         Tparticle a;
         a.id=0;
         Tspace::Tpvec p(2, a);
@@ -450,6 +596,44 @@ namespace Faunus {
         c.groups[0].all=true;
         spc1.sync(spc2, c);
         CHECK( spc1.p.back().pos.z() == doctest::Approx(-0.1) );
+
+        // particle-to-group lookup
+        spc1.push_back(0, p);
+        CHECK( spc1.groupindex == std::vector<int>({0,0,1,1}) );
+        CHECK( spc1.findGroupContaining(spc1.p[3]) == spc1.groups.begin()+1 );
+        spc1.groups[1].resize(1); // deactivate last particle
+        CHECK( spc1.findGroupContaining(spc1.p[3]) == spc1.groups.end() );
+        CHECK( spc1.findGroupContaining(a) == spc1.groups.end() );
+        spc1.groupindex[3] = 5; // stale entry must not be dereferenced
+        CHECK( spc1.findGroupContaining(spc1.p[3]) == spc1.groups.end() );
+        spc1.groupindex[3] = 1;
+
+        CHECK( spc1.memory() >= 4*sizeof(Tparticle) + 2*sizeof(Tspace::Tgroup) );
+
+        // memory placement must preserve particles, groups and their addresses
+        auto pcopy = spc1.p;
+        auto pdata = spc1.p.data();
+        spc1.placeMemory();
+        CHECK( spc1.p.data()==pdata );
+        CHECK( spc1.p.size()==pcopy.size() );
+        CHECK( spc1.p[1].pos.x()==doctest::Approx(pcopy[1].pos.x()) );
+        CHECK( spc1.groups[1].begin()==spc1.p.begin()+2 );
+        CHECK( spc1.groups[1].size()==1 );
+        CHECK( spc1.groups[1].capacity()==2 );
+        CHECK( spc1.domainOrder().size()==2 );
+
+        // active particles only
+        CHECK( ranges::distance(spc1.activeParticles()) == 3 );
+        CHECK( &*spc1.activeParticles().begin() == &spc1.p[0] );
+
+        // touched group index must be sorted and unique
+        c.groups.resize(3);
+        c.groups[0].index=4;
+        c.groups[1].index=1;
+        c.groups[2].index=4;
+        CHECK( c.touchedGroupIndex() == std::vector<int>({1,4}) );
+        atoms<Tparticle> = atombackup;
+        molecules<typename Tspace::Tpvec> = molbackup;
     }
 #endif
 
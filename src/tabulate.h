@@ -7,6 +7,15 @@
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <map>
+#include <string>
+#include <fstream>
+#include <unistd.h>
+#include <limits>
+#include <cstdint>
+#include <cstdio>
+#include <unistd.h>
+#include <iterator>
 
 namespace Faunus
 {
@@ -319,6 +328,122 @@ namespace Faunus
                 }
         };
 
+        /**
+         * @brief Content-addressed cache of generated tables
+         *
+         * Tables are stored in memory under a key that must describe everything
+         * the table depends on (function, parameters, tolerances). If `directory`
+         * is set, tables are also written to and read from disk, one file per key.
+         * The directory is taken from the environment variable `FAUNUS_TABLE_CACHE`.
+         */
+        template<typename T=double>
+            class TableCache
+        {
+            public:
+                typedef typename TabulatorBase<T>::data Tdata;
+
+            private:
+                std::map<std::string, Tdata> tables;
+
+                static std::uint64_t fnv1a(const void *data, size_t size, std::uint64_t h=14695981039346656037ull) {
+                    auto c = static_cast<const unsigned char*>(data);
+                    for (size_t i=0; i<size; i++) {
+                        h ^= c[i];
+                        h *= 1099511628211ull;
+                    }
+                    return h;
+                } //!< FNV-1a hash of raw bytes
+
+                static std::uint64_t checksum(const Tdata &d) {
+                    std::uint64_t h = fnv1a(&d.rmin2, sizeof(d.rmin2));
+                    h = fnv1a(&d.rmax2, sizeof(d.rmax2), h);
+                    h = fnv1a(d.r2.data(), d.r2.size()*sizeof(T), h);
+                    return fnv1a(d.c.data(), d.c.size()*sizeof(T), h);
+                } //!< Checksum of table data; values are written with enough digits to round-trip exactly
+
+                bool load(const std::string &key, Tdata &d) const {
+                    std::ifstream f( filename(key) );
+                    std::string _key, tag;
+                    size_t n1, n2;
+                    unsigned long long sum;
+                    if (!f || !std::getline(f, _key) || _key!=key) // also guards against hash collisions
+                        return false;
+                    if (!(f >> d.rmin2 >> d.rmax2 >> n1 >> n2))
+                        return false;
+                    d.r2.resize(n1);
+                    d.c.resize(n2);
+                    for (auto &x : d.r2)
+                        f >> x;
+                    for (auto &x : d.c)
+                        f >> x;
+                    if (!(f >> tag >> std::hex >> sum) || tag!="checksum") // missing if the file is truncated
+                        return false;
+                    return sum==checksum(d);
+                }
+
+                void save(const std::string &key, const Tdata &d) const {
+                    std::string file = filename(key);
+                    std::string tmp = file + "." + std::to_string(getpid()) + ".tmp"; // unique for concurrent runs
+                    std::ofstream f(tmp);
+                    if (f) {
+                        f.precision( std::numeric_limits<T>::max_digits10 );
+                        f << key << "\n" << d.rmin2 << " " << d.rmax2 << " " << d.r2.size() << " " << d.c.size() << "\n";
+                        for (auto x : d.r2)
+                            f << x << "\n";
+                        for (auto x : d.c)
+                            f << x << "\n";
+                        f << "checksum " << std::hex << (unsigned long long)checksum(d) << "\n";
+                        f.close();
+                        if (f)
+                            std::rename(tmp.c_str(), file.c_str()); // atomic replace; readers never see a partial file
+                        else
+                            std::remove(tmp.c_str());
+                    }
+                }
+
+            public:
+                std::string directory; //!< Directory for persistent tables (empty = memory only)
+                size_t hits=0, misses=0;
+
+                std::string filename(const std::string &key) const {
+                    char buf[17];
+                    std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)fnv1a(key.data(), key.size()));
+                    return directory + "/table-" + buf + ".dat";
+                } //!< File for table `key` in `directory`
+
+                TableCache() {
+                    if (const char *dir = std::getenv("FAUNUS_TABLE_CACHE"))
+                        directory = dir;
+                }
+
+                template<class Tgenerator>
+                    const Tdata& get(const std::string &key, Tgenerator generate) {
+                        auto it = tables.find(key);
+                        if (it!=tables.end()) {
+                            hits++;
+                            return it->second;
+                        }
+                        Tdata d;
+                        if (!directory.empty() && load(key, d))
+                            hits++;
+                        else {
+                            misses++;
+                            d = generate();
+                            if (!directory.empty())
+                                save(key, d);
+                        }
+                        return tables[key] = d;
+                    } //!< Get table for `key`; call `generate()` only if not cached
+
+                void clear() { tables.clear(); } //!< Clear in-memory tables
+        };
+
+        template<typename T=double>
+            TableCache<T>& tableCache() {
+                static TableCache<T> cache;
+                return cache;
+            } //!< Process-wide table cache
+
 #ifdef DOCTEST_LIBRARY_INCLUDED
         TEST_CASE("[Faunus] Andrea")
         {
@@ -334,6 +459,54 @@ namespace Faunus
             CHECK( spline.eval(d,5) == Approx(f(5)) );
             CHECK( spline.eval(d,10) == Approx(f(10)) );
             CHECK( spline.eval(d,10+1e-9) != Approx(10+1e-9));
+
+            // identical keys generate only once
+            TableCache<double> cache;
+            cache.directory.clear();
+            int cnt=0;
+            auto gen = [&]() { cnt++; return spline.generate(f, 0, 10); };
+            auto &d1 = cache.get("test", gen);
+            auto &d2 = cache.get("test", gen);
+            CHECK( cnt==1 );
+            CHECK( &d1==&d2 );
+            CHECK( d1.c==d.c );
+            cache.get("other", gen);
+            CHECK( cnt==2 );
+
+            SUBCASE("disk round trip") {
+                cache.directory = ".";
+                std::string key = "disk-" + std::to_string(getpid()); // unique if tests run concurrently, e.g. under MPI
+                std::string file = cache.filename(key);
+                std::remove(file.c_str());
+                cache.get(key, gen); // generated and saved
+                CHECK( cnt==3 );
+
+                TableCache<double> other;
+                other.directory = ".";
+                CHECK( other.get(key, gen).c==d.c ); // loaded
+                CHECK( other.hits==1 );
+                CHECK( cnt==3 );
+
+                std::string content;
+                {
+                    std::ifstream in(file);
+                    content.assign( std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() );
+                }
+                for (size_t n : {content.size()/2, content.rfind("checksum")-3}) { // mid-file and within the last value
+                    std::ofstream(file) << content.substr(0, n); // e.g. a writer was interrupted
+                    TableCache<double> truncated;
+                    truncated.directory = ".";
+                    CHECK( truncated.get(key, gen).c==d.c ); // rejected and regenerated...
+                    CHECK( truncated.misses==1 );
+                }
+                CHECK( cnt==5 );
+
+                TableCache<double> repaired;
+                repaired.directory = ".";
+                repaired.get(key, gen); // ...and saved again
+                CHECK( repaired.hits==1 );
+                std::remove(file.c_str());
+            }
         }
 #endif
 